@@ -0,0 +1,28 @@
+#!/bin/bash
+
+# compare the boarding protocols: handshake, reduced handshake (-F) and lock-free queue (-L)
+# (build with a larger N for meaningful figures, e.g. make all NPASS=2000)
+
+case $# in
+    0) n=5;;
+    *) n=$1; shift;;
+esac
+
+if ! [ $n -gt 0 ] 2>/dev/null; then
+    echo "USAGE: $0 [«number-of-runs» [launcher options]]"
+    exit 1
+fi
+
+for proto in "handshake:" "fast:-F" "lockfree:-L"
+do
+    name=${proto%%:*}
+    opt=${proto#*:}
+    for i in $(seq 1 $n)
+    do
+        ./probSemSharedMemAirLift $opt "$@" bench.log > /dev/null
+        awk -v name=$name '/achieved throughput/ { thr = $7; span = $10 }
+                           /^Semaphore operations/ { ops = $5 }
+                           END { printf "%-10s %10.2f passengers/s %8.3f s %8s semops/passenger\n", name, thr, span, ops }' bench.log
+    done
+done
+rm -f bench.log
@@ -3,8 +3,5 @@
 rm -f error*
 rm -f core
 
-# change 0x610661c3 to your semaphore and shared memory key
-ipcrm -S 0x61070a49
-
-ipcrm -M 0x61070a49
-
+# remove the semaphore set and shared memory region left by a crashed run
+./probSemSharedMemAirLift --clean
@@ -0,0 +1,33 @@
+#!/bin/bash
+
+# service mode with a destination holding fewer passengers than the minimum load of a flight (seed 4 gives
+# destination 1 only 4 passengers): every run must complete its flights instead of waiting for a full plane
+
+case $# in
+    0) n=10;;
+    1) n=$1;;
+    *) echo "USAGE: $0 «number-of-runs»"; exit 1;;
+esac
+
+if ! [ $n -gt 0 ] 2>/dev/null; then
+    echo "Wrong argument value (\"$n\"). Aborting."
+    exit 1
+fi
+
+failed=0
+for i in $(seq 1 $n)
+do
+    for routing in longest cyclic
+    do
+        if ! timeout 60 ./probSemSharedMemAirLift -s 4 -T3:$routing -S -f 20 sparse.log > /dev/null 2>&1 ||
+           ! grep -q "^Flight 20 : Departed" sparse.log; then
+            echo "Run n.º $i ($routing routing) did not complete its flights"
+            ./probSemSharedMemAirLift --clean > /dev/null 2>&1
+            failed=$((failed + 1))
+        fi
+    done
+done
+rm -f sparse.log
+
+echo "$((2 * n - failed)) of $((2 * n)) runs completed"
+[ $failed -eq 0 ]
@@ -0,0 +1,341 @@
+/**
+ *  \file accounting.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Resource accounting of the intervening entities processes.
+ *
+ *  The launcher records, for every process it generates, the exit status, the wall lifetime, the user and system
+ *  CPU time, the voluntary and involuntary context switches and the maximum resident set size.
+ *
+ *  Defined operations:
+ *     \li accounting initialization
+ *     \li registration of a generated process
+ *     \li registration of a terminated process
+ *     \li test for termination of a process
+ *     \li signalling of the processes still alive
+ *     \li writing the resource usage summary at the end of the logging file
+ *     \li accounting destruction.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "accounting.h"
+
+/** \brief number of accounted figures per process */
+#define  NFIG                         6
+
+/** \brief figure names */
+static const char *figName[NFIG] = {"wall(ms)", "user(ms)", "sys(ms)", "vcsw", "ivcsw", "maxrss(kB)"};
+
+/** \brief role names */
+static const char *roleName[] = {"pilot", "hostess", "passenger", "watchdog"};
+
+/**
+ *  \brief Definition of <em>process accounting record</em> data type.
+ */
+typedef struct
+{ /** \brief process identifier */
+    int pid;
+    /** \brief entity role */
+    unsigned int role;
+    /** \brief id of the first entity hosted by the process */
+    unsigned int first;
+    /** \brief id of the last entity hosted by the process */
+    unsigned int last;
+    /** \brief process was reaped */
+    bool reaped;
+    /** \brief exit status */
+    int status;
+    /** \brief spawn time */
+    struct timespec start;
+    /** \brief accounted figures (see figName) */
+    double fig[NFIG];
+
+} ACCT_REC;
+
+/** \brief accounting records */
+static ACCT_REC *rec;
+
+/** \brief number of records in use */
+static unsigned int nRec;
+
+/** \brief maximum number of records */
+static unsigned int capRec;
+
+/** \brief open addressing table mapping process identifiers onto records (-1 if free) */
+static int *pidMap;
+
+/** \brief size of the pid table (power of two) */
+static unsigned int mapSize;
+
+static unsigned int pidSlot (int pid)
+{
+    unsigned int h = ((unsigned int) pid * 2654435761u) & (mapSize - 1);
+
+    while ((pidMap[h] != -1) && (rec[pidMap[h]].pid != pid))
+        h = (h + 1) & (mapSize - 1);
+    return h;
+}
+
+static int cmpDouble (const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+
+    return (x > y) - (x < y);
+}
+
+static void printRow (FILE *fic, const char *name, const char *status, const double fig[])
+{
+    int f;
+
+    fprintf (fic, "%-18s%8s", name, status);
+    for (f = 0; f < NFIG; f++)
+        fprintf (fic, " %11.1f", fig[f]);
+    fprintf (fic, "\n");
+}
+
+static void printStatus (char buf[], int status)
+{
+    if (WIFEXITED (status))
+        sprintf (buf, "%d", WEXITSTATUS (status));
+    else if (WIFSIGNALED (status))
+        sprintf (buf, "sig%d", WTERMSIG (status));
+    else sprintf (buf, "?");
+}
+
+/**
+ *  \brief Accounting initialization.
+ *
+ *  \param cap maximum number of processes to be accounted
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int acctInit (unsigned int cap)
+{
+    unsigned int i;
+
+    for (mapSize = 1; mapSize < 2 * cap; mapSize *= 2)
+        ;
+    if ((rec = malloc (cap * sizeof (ACCT_REC))) == NULL)
+        return -1;
+    if ((pidMap = malloc (mapSize * sizeof (int))) == NULL) {
+        free (rec);
+        return -1;
+    }
+    for (i = 0; i < mapSize; i++)
+        pidMap[i] = -1;
+    nRec = 0;
+    capRec = cap;
+    return 0;
+}
+
+/**
+ *  \brief Registration of a generated process.
+ *
+ *  The start of its wall lifetime is taken at the moment of the call.
+ *
+ *  \param pid process identifier
+ *  \param role entity role
+ *  \param first id of the first entity hosted by the process
+ *  \param last id of the last entity hosted by the process
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the accounting table is full
+ */
+
+int acctSpawned (int pid, unsigned int role, unsigned int first, unsigned int last)
+{
+    ACCT_REC *r;
+
+    if (nRec == capRec) {
+        errno = ENOSPC;
+        return -1;
+    }
+    r = &rec[nRec];
+    memset (r, 0, sizeof (ACCT_REC));
+    r->pid = pid;
+    r->role = role;
+    r->first = first;
+    r->last = last;
+    clock_gettime (CLOCK_MONOTONIC, &r->start);
+    pidMap[pidSlot (pid)] = nRec++;
+    return 0;
+}
+
+/**
+ *  \brief Registration of a terminated process.
+ *
+ *  \param pid process identifier
+ *  \param status exit status, as returned by <tt>wait4</tt>
+ *  \param ru resource usage, as returned by <tt>wait4</tt>
+ *
+ *  \return entity role, upon success
+ *  \return -\c 1, when the process was not registered
+ */
+
+int acctReaped (int pid, int status, const struct rusage *ru)
+{
+    ACCT_REC *r;
+    struct timespec now;
+    int i = pidMap[pidSlot (pid)];
+
+    if (i == -1)
+        return -1;
+    r = &rec[i];
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    r->reaped = true;
+    r->status = status;
+    r->fig[0] = (now.tv_sec - r->start.tv_sec) * 1e3 + (now.tv_nsec - r->start.tv_nsec) / 1e6;
+    r->fig[1] = ru->ru_utime.tv_sec * 1e3 + ru->ru_utime.tv_usec / 1e3;
+    r->fig[2] = ru->ru_stime.tv_sec * 1e3 + ru->ru_stime.tv_usec / 1e3;
+    r->fig[3] = ru->ru_nvcsw;
+    r->fig[4] = ru->ru_nivcsw;
+    r->fig[5] = ru->ru_maxrss;
+    return (int) r->role;
+}
+
+/**
+ *  \brief Test for termination of a process.
+ *
+ *  \param pid process identifier
+ *
+ *  \return \c true if the process was registered and already reaped
+ */
+
+bool acctIsReaped (int pid)
+{
+    int i = pidMap[pidSlot (pid)];
+
+    return (i != -1) && rec[i].reaped;
+}
+
+/**
+ *  \brief Signalling of the processes still alive.
+ *
+ *  Sends <tt>sig</tt> to every registered process that was not reaped yet.
+ *  It is async-signal-safe and may be called from a signal handler.
+ *
+ *  \param sig signal number
+ */
+
+void acctKill (int sig)
+{
+    unsigned int i;
+
+    for (i = 0; i < nRec; i++)
+        if (!rec[i].reaped)
+            kill (rec[i].pid, sig);
+}
+
+/**
+ *  \brief Writing the resource usage summary at the end of the file.
+ *
+ *  The summary holds the pilot, hostess and watchdog figures, the totals over all processes and the percentiles across
+ *  passenger processes.
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ */
+
+void acctReport (char nFic[])
+{
+    static const double pct[] = {50.0, 90.0, 99.0, 100.0};
+    FILE *fic;                                                                                      /* file descriptor */
+    double total[NFIG] = {0.0}, row[NFIG];
+    double *val;                                                            /* values of one figure across passengers */
+    unsigned int i, nPG = 0, nRole[4] = {0}, nFail = 0, q;
+    int f;
+    char name[32], status[12];
+
+    if ((nFic == NULL) || (strlen (nFic) == 0))
+        fic = stdout;
+    else if ((fic = fopen (nFic, "a")) == NULL) {
+        perror ("error on opening log file");
+        exit (EXIT_FAILURE);
+    }
+
+    for (i = 0; i < nRec; i++)                           /* several pilots or hostesses are told apart by their id */
+        nRole[rec[i].role] += 1;
+
+    fprintf (fic, "Resource usage\n");
+    fprintf (fic, "%-18s%8s", "entity", "status");
+    for (f = 0; f < NFIG; f++)
+        fprintf (fic, " %11s", figName[f]);
+    fprintf (fic, "\n");
+
+    for (i = 0; i < nRec; i++) {
+        if (!rec[i].reaped)
+            continue;
+        for (f = 0; f < NFIG; f++)
+            total[f] += rec[i].fig[f];
+        if (!WIFEXITED (rec[i].status) || (WEXITSTATUS (rec[i].status) != 0))
+            nFail += 1;
+        if (rec[i].role == ACCT_PASSENGER) {
+            nPG += 1;
+            continue;
+        }
+        printStatus (status, rec[i].status);
+        if (((rec[i].role == ACCT_PILOT) || (rec[i].role == ACCT_HOSTESS)) && (nRole[rec[i].role] > 1))
+            sprintf (name, "%s %u", roleName[rec[i].role], rec[i].first);
+        else strcpy (name, roleName[rec[i].role]);
+        printRow (fic, name, status, rec[i].fig);
+    }
+
+    if ((nPG > 0) && ((val = malloc (NFIG * nPG * sizeof (double))) != NULL)) {
+        unsigned int k = 0;
+
+        for (i = 0; i < nRec; i++)
+            if (rec[i].reaped && (rec[i].role == ACCT_PASSENGER)) {
+                for (f = 0; f < NFIG; f++)
+                    val[f * nPG + k] = rec[i].fig[f];
+                k += 1;
+            }
+        for (f = 0; f < NFIG; f++)
+            qsort (val + f * nPG, nPG, sizeof (double), cmpDouble);
+        for (q = 0; q < sizeof (pct) / sizeof (pct[0]); q++) {
+            for (f = 0; f < NFIG; f++)
+                row[f] = val[f * nPG + (unsigned int) ((pct[q] / 100.0) * (nPG - 1) + 0.5)];
+            if (pct[q] == 100.0)
+                sprintf (name, "passengers max");
+            else sprintf (name, "passengers p%.0f", pct[q]);
+            printRow (fic, name, "", row);
+        }
+        free (val);
+    }
+
+    sprintf (name, "total (%u procs)", nRec);
+    sprintf (status, "%u err", nFail);
+    printRow (fic, name, status, total);
+
+    if (fic != stdout) {
+        if (fclose (fic) == EOF) {
+            perror ("error on closing of log file");
+            exit (EXIT_FAILURE);
+        }
+    }
+    else fflush (fic);
+}
+
+/**
+ *  \brief Accounting destruction.
+ */
+
+void acctFree (void)
+{
+    free (rec);
+    free (pidMap);
+    rec = NULL;
+    pidMap = NULL;
+    nRec = capRec = mapSize = 0;
+}
@@ -0,0 +1,117 @@
+/**
+ *  \file accounting.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Resource accounting of the intervening entities processes.
+ *
+ *  The launcher records, for every process it generates, the exit status, the wall lifetime, the user and system
+ *  CPU time, the voluntary and involuntary context switches and the maximum resident set size.
+ *
+ *  Defined operations:
+ *     \li accounting initialization
+ *     \li registration of a generated process
+ *     \li registration of a terminated process
+ *     \li test for termination of a process
+ *     \li signalling of the processes still alive
+ *     \li writing the resource usage summary at the end of the logging file
+ *     \li accounting destruction.
+ */
+
+#ifndef ACCOUNTING_H_
+#define ACCOUNTING_H_
+
+#include <stdbool.h>
+#include <sys/resource.h>
+
+/* Entity roles */
+
+/** \brief pilot process */
+#define  ACCT_PILOT                   0
+/** \brief hostess process */
+#define  ACCT_HOSTESS                 1
+/** \brief passenger (or passenger worker) process */
+#define  ACCT_PASSENGER               2
+/** \brief watchdog process */
+#define  ACCT_WATCHDOG                3
+
+/**
+ *  \brief Accounting initialization.
+ *
+ *  \param cap maximum number of processes to be accounted
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int acctInit (unsigned int cap);
+
+/**
+ *  \brief Registration of a generated process.
+ *
+ *  The start of its wall lifetime is taken at the moment of the call.
+ *
+ *  \param pid process identifier
+ *  \param role entity role
+ *  \param first id of the first entity hosted by the process
+ *  \param last id of the last entity hosted by the process
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the accounting table is full
+ */
+
+extern int acctSpawned (int pid, unsigned int role, unsigned int first, unsigned int last);
+
+/**
+ *  \brief Registration of a terminated process.
+ *
+ *  \param pid process identifier
+ *  \param status exit status, as returned by <tt>wait4</tt>
+ *  \param ru resource usage, as returned by <tt>wait4</tt>
+ *
+ *  \return entity role, upon success
+ *  \return -\c 1, when the process was not registered
+ */
+
+extern int acctReaped (int pid, int status, const struct rusage *ru);
+
+/**
+ *  \brief Test for termination of a process.
+ *
+ *  \param pid process identifier
+ *
+ *  \return \c true if the process was registered and already reaped
+ */
+
+extern bool acctIsReaped (int pid);
+
+/**
+ *  \brief Signalling of the processes still alive.
+ *
+ *  Sends <tt>sig</tt> to every registered process that was not reaped yet.
+ *  It is async-signal-safe and may be called from a signal handler.
+ *
+ *  \param sig signal number
+ */
+
+extern void acctKill (int sig);
+
+/**
+ *  \brief Writing the resource usage summary at the end of the file.
+ *
+ *  The summary holds the pilot, hostess and watchdog figures, the totals over all processes and the percentiles across
+ *  passenger processes.
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ */
+
+extern void acctReport (char nFic[]);
+
+/**
+ *  \brief Accounting destruction.
+ */
+
+extern void acctFree (void);
+
+#endif /* ACCOUNTING_H_ */
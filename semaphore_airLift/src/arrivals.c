@@ -0,0 +1,345 @@
+/**
+ *  \file arrivals.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Open-loop generation of the passengers arrival times at the airport.
+ *
+ *  The arrival times are drawn (or read from a trace file) by the launcher before the start of operations, independently of the state of the
+ *  simulation, and are stored in the shared region as offsets (in us) from the start of operations.
+ *
+ *  Defined operations:
+ *     \li parsing of an arrival process specification
+ *     \li generation of the arrival times
+ *     \li computation of the offered load
+ *     \li computation of an absolute arrival deadline
+ *     \li computation of the time elapsed since the start of operations
+ *     \li sleeping until an absolute deadline.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "prng.h"
+#include "arrivals.h"
+
+/**
+ *  \brief Parsing of a non-negative decimal number in a memory-mapped text.
+ *
+ *  The text is not null terminated, so the standard conversion functions cannot be used. The number may have a
+ *  fractional part and an exponent (e.g. <tt>1.5e-3</tt>) and must end the field: it is followed by a separator
+ *  (comma, semicolon, blank), the end of the line or the end of the text.
+ *
+ *  \param p pointer to the current position (advanced past the number)
+ *  \param end end of the text
+ *  \param val pointer to the location where the value is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the field is not a non-negative number
+ */
+
+static int parseDecimal (const char **p, const char *end, double *val)
+{
+    const char *q = *p;
+    double v = 0.0, scale = 1.0;
+    bool digits = false, negExp = false;
+    int e = 0;                                                                                        /* exponent */
+
+    if ((q < end) && (*q == '+'))
+        q++;
+    while ((q < end) && (*q >= '0') && (*q <= '9')) {
+        v = 10.0 * v + (*q++ - '0');
+        digits = true;
+    }
+    if ((q < end) && (*q == '.'))
+        for (q++; (q < end) && (*q >= '0') && (*q <= '9'); q++) {
+            scale /= 10.0;
+            v += scale * (*q - '0');
+            digits = true;
+        }
+    if (!digits)
+        return -1;
+    if ((q < end) && ((*q == 'e') || (*q == 'E'))) {
+        q++;
+        if ((q < end) && ((*q == '+') || (*q == '-')))
+            negExp = (*q++ == '-');
+        if ((q == end) || (*q < '0') || (*q > '9'))
+            return -1;
+        while ((q < end) && (*q >= '0') && (*q <= '9') && (e < 1000))
+            e = 10 * e + (*q++ - '0');
+        v *= pow (10.0, negExp ? -e : e);
+    }
+    if ((q < end) && ((*q == '\0') || (strchr (",; \t\r\n", *q) == NULL)))
+        return -1;
+    *p = q;
+    *val = v;
+    return 0;
+}
+
+/**
+ *  \brief Loading of the arrival times from a trace file.
+ *
+ *  \param name name of the trace file
+ *  \param arrival array where the arrival times (us after start of operations) are stored
+ *  \param n number of passengers
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+static int loadTrace (const char *name, unsigned long arrival[], unsigned int n)
+{
+    int fd;                                                                                     /* file descriptor */
+    struct stat st;                                                                                 /* file status */
+    const char *map, *p, *end;                                                                   /* mapped contents */
+    unsigned long first = ~0UL;                                                               /* earliest arrival */
+    unsigned int k = 0;
+    double t;
+    size_t len = strlen (name);
+
+    if ((fd = open (name, O_RDONLY)) == -1)
+        return -1;
+    if (fstat (fd, &st) == -1) {
+        close (fd);
+        return -1;
+    }
+    if (st.st_size == 0) {
+        close (fd);
+        errno = ENODATA;
+        return -1;
+    }
+    if ((map = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+        close (fd);
+        return -1;
+    }
+    close (fd);
+    madvise ((void *) map, st.st_size, MADV_SEQUENTIAL);
+    end = map + st.st_size;
+
+    if ((len > 4) && (strcmp (name + len - 4, ".bin") == 0)) {                                     /* binary trace */
+        const uint64_t *rec = (const uint64_t *) map;
+
+        for (k = 0; (k < n) && ((k + 1) * sizeof (uint64_t) <= (size_t) st.st_size); k++)
+            arrival[k] = (unsigned long) rec[k];
+    }
+    else for (p = map; (p < end) && (k < n); ) {                                                      /* text trace */
+        while ((p < end) && ((*p == ' ') || (*p == '\t')))
+            p++;
+        if ((p < end) && (((*p >= '0') && (*p <= '9')) || (*p == '+') || (*p == '-') || (*p == '.'))) {  /* data */
+            if ((*p == '-') || (parseDecimal (&p, end, &t) == -1)) {
+                munmap ((void *) map, st.st_size);
+                errno = EINVAL;
+                return -1;
+            }
+            arrival[k++] = (unsigned long) floor (t * 1e6 + 0.5);
+        }
+        while ((p < end) && (*p != '\n'))                                               /* rest of the record */
+            p++;
+        p++;
+    }
+    munmap ((void *) map, st.st_size);
+
+    if (k < n) {
+        errno = ENODATA;
+        return -1;
+    }
+    for (k = 0; k < n; k++)
+        if (arrival[k] < first)
+            first = arrival[k];
+    for (k = 0; k < n; k++)
+        arrival[k] -= first;
+    return 0;
+}
+
+/**
+ *  \brief Parsing of an arrival process specification.
+ *
+ *  Accepted specifications:
+ *     \li <tt>uniform</tt>: independent travel times in [1 ms, MAXTRAVEL + 1 ms] (default)
+ *     \li <tt>poisson:</tt><em>rate</em>: Poisson process with <em>rate</em> passengers per second
+ *     \li <tt>constant:</tt><em>rate</em>: one passenger every 1/<em>rate</em> seconds
+ *     \li <tt>onoff:</tt><em>rate</em><tt>:</tt><em>on</em><tt>:</tt><em>off</em>: Poisson bursts of <em>on</em>
+ *         seconds separated by <em>off</em> seconds without arrivals
+ *     \li <tt>trace:</tt><em>file</em>: arrival times replayed from a trace file (see arrivalGenerate).
+ *
+ *  \param spec specification
+ *  \param ap pointer to the location where the arrival process is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the specification is malformed
+ */
+
+int arrivalParse (const char *spec, ARRIVAL_PROC *ap)
+{
+    int n = 0;                                                                            /* characters consumed */
+
+    memset (ap, 0, sizeof (ARRIVAL_PROC));
+    if (strcmp (spec, "uniform") == 0)
+        ap->kind = ARR_UNIFORM;
+    else if ((sscanf (spec, "poisson:%lf%n", &ap->rate, &n) == 1) && (spec[n] == '\0'))
+        ap->kind = ARR_POISSON;
+    else if ((sscanf (spec, "constant:%lf%n", &ap->rate, &n) == 1) && (spec[n] == '\0'))
+        ap->kind = ARR_CONSTANT;
+    else if ((sscanf (spec, "onoff:%lf:%lf:%lf%n", &ap->rate, &ap->on, &ap->off, &n) == 3) && (spec[n] == '\0')
+             && (ap->on > 0.0) && (ap->off >= 0.0))
+        ap->kind = ARR_ONOFF;
+    else if ((strncmp (spec, "trace:", 6) == 0) && (strlen (spec + 6) > 0) && (strlen (spec + 6) < MAXPATH)) {
+        ap->kind = ARR_TRACE;
+        strcpy (ap->trace, spec + 6);
+    }
+    else return -1;
+
+    if ((ap->kind != ARR_UNIFORM) && (ap->kind != ARR_TRACE) && (ap->rate <= 0.0))
+        return -1;
+    return 0;
+}
+
+/**
+ *  \brief Generation of the arrival times.
+ *
+ *  The uniform process draws from the passenger streams, the other random processes from the launcher stream.
+ *
+ *  A trace file is memory-mapped and its first <tt>n</tt> records are used, shifted so that the earliest arrival
+ *  takes place at the start of operations. Two formats are accepted:
+ *     \li binary (name ending in <tt>.bin</tt>): native 64-bit unsigned integers, in us
+ *     \li text (CSV): one record per line, whose first field is the arrival time in seconds, a non-negative
+ *         decimal number, possibly with an exponent; lines not starting with a digit, a sign or a point (headers,
+ *         comments, blank lines) are skipped, and a malformed number fails the load with <tt>EINVAL</tt>.
+ *
+ *  \param ap pointer to the arrival process
+ *  \param seed master seed of the run
+ *  \param arrival array where the arrival times (us after start of operations) are stored
+ *  \param n number of passengers
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the trace file cannot be read , holds less than <tt>n</tt> records or a malformed one (the
+ *     actual situation is reported in <tt>errno</tt>)
+ */
+
+int arrivalGenerate (const ARRIVAL_PROC *ap, uint64_t seed, unsigned long arrival[], unsigned int n)
+{
+    PRNG rng;                                                                                   /* random generator */
+    double t = 0.0,                                                                        /* current time (s) */
+           onEnd = ap->on;                                                     /* end of the current burst (s) */
+    unsigned int p;
+
+    if (ap->kind == ARR_TRACE)
+        return loadTrace (ap->trace, arrival, n);
+
+    prngInit (&rng, prngSeed (seed, SEED_LAUNCHER, 0));
+    for (p = 0; p < n; p++) {
+        switch (ap->kind) {
+            case ARR_UNIFORM:                                  /* same draw as the travel time of the passenger */
+                prngInit (&rng, prngSeed (seed, SEED_PASSENGER, p));
+                arrival[p] = (unsigned long) floor (MAXTRAVEL * prngUniform (&rng) + 1000);
+                continue;
+            case ARR_CONSTANT:
+                t += 1.0 / ap->rate;
+                break;
+            case ARR_POISSON:
+                t += -log (1.0 - prngUniform (&rng)) / ap->rate;
+                break;
+            case ARR_ONOFF:                     /* memoryless: a gap crossing the end of a burst resumes in the next */
+                t += -log (1.0 - prngUniform (&rng)) / ap->rate;
+                while (t > onEnd) {
+                    t += ap->off;
+                    onEnd += ap->on + ap->off;
+                }
+                break;
+        }
+        arrival[p] = (unsigned long) floor (t * 1e6);
+    }
+    return 0;
+}
+
+/**
+ *  \brief Computation of the offered load.
+ *
+ *  \param arrival arrival times (us after start of operations)
+ *  \param n number of passengers
+ *
+ *  \return mean arrival rate between the first and the last arrival (passengers per second)
+ */
+
+double arrivalOfferedLoad (const unsigned long arrival[], unsigned int n)
+{
+    unsigned long first = arrival[0], last = arrival[0];
+    unsigned int p;
+
+    for (p = 1; p < n; p++) {
+        if (arrival[p] < first)
+            first = arrival[p];
+        if (arrival[p] > last)
+            last = arrival[p];
+    }
+    return (last > first) ? (n - 1) / ((last - first) / 1e6) : 0.0;
+}
+
+/**
+ *  \brief Computation of an absolute arrival deadline.
+ *
+ *  \param start start of operations (<tt>CLOCK_MONOTONIC</tt>)
+ *  \param us offset (us)
+ *  \param at pointer to the location where the deadline is stored
+ */
+
+void arrivalDeadline (const struct timespec *start, unsigned long us, struct timespec *at)
+{
+    at->tv_sec = start->tv_sec + us / 1000000;
+    at->tv_nsec = start->tv_nsec + (us % 1000000) * 1000;
+    if (at->tv_nsec >= 1000000000) {
+        at->tv_sec += 1;
+        at->tv_nsec -= 1000000000;
+    }
+}
+
+/**
+ *  \brief Computation of the time elapsed since the start of operations.
+ *
+ *  \param start start of operations (<tt>CLOCK_MONOTONIC</tt>)
+ *
+ *  \return elapsed time (us)
+ */
+
+unsigned long elapsedSince (const struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (unsigned long) ((now.tv_sec - start->tv_sec) * 1000000 + (now.tv_nsec - start->tv_nsec) / 1000);
+}
+
+/**
+ *  \brief Sleeping until an absolute deadline.
+ *
+ *  \param at deadline (<tt>CLOCK_MONOTONIC</tt>)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int sleepUntil (const struct timespec *at)
+{
+    int stat;
+
+    while ((stat = clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, at, NULL)) == EINTR)
+        ;                                                                                 /* interrupted: resume */
+    if (stat != 0) {
+        errno = stat;
+        return -1;
+    }
+
+    return 0;
+}
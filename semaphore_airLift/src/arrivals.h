@@ -0,0 +1,116 @@
+/**
+ *  \file arrivals.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Open-loop generation of the passengers arrival times at the airport.
+ *
+ *  The arrival times are drawn (or read from a trace file) by the launcher before the start of operations, independently of the state of the
+ *  simulation, and are stored in the shared region as offsets (in us) from the start of operations.
+ *
+ *  Defined operations:
+ *     \li parsing of an arrival process specification
+ *     \li generation of the arrival times
+ *     \li computation of the offered load
+ *     \li computation of an absolute arrival deadline
+ *     \li computation of the time elapsed since the start of operations
+ *     \li sleeping until an absolute deadline.
+ */
+
+#ifndef ARRIVALS_H_
+#define ARRIVALS_H_
+
+#include <stdint.h>
+#include <time.h>
+
+#include "probDataStruct.h"
+
+/**
+ *  \brief Parsing of an arrival process specification.
+ *
+ *  Accepted specifications:
+ *     \li <tt>uniform</tt>: independent travel times in [1 ms, MAXTRAVEL + 1 ms] (default)
+ *     \li <tt>poisson:</tt><em>rate</em>: Poisson process with <em>rate</em> passengers per second
+ *     \li <tt>constant:</tt><em>rate</em>: one passenger every 1/<em>rate</em> seconds
+ *     \li <tt>onoff:</tt><em>rate</em><tt>:</tt><em>on</em><tt>:</tt><em>off</em>: Poisson bursts of <em>on</em>
+ *         seconds separated by <em>off</em> seconds without arrivals
+ *     \li <tt>trace:</tt><em>file</em>: arrival times replayed from a trace file (see arrivalGenerate).
+ *
+ *  \param spec specification
+ *  \param ap pointer to the location where the arrival process is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the specification is malformed
+ */
+
+extern int arrivalParse (const char *spec, ARRIVAL_PROC *ap);
+
+/**
+ *  \brief Generation of the arrival times.
+ *
+ *  The uniform process draws from the passenger streams, the other random processes from the launcher stream.
+ *
+ *  A trace file is memory-mapped and its first <tt>n</tt> records are used, shifted so that the earliest arrival
+ *  takes place at the start of operations. Two formats are accepted:
+ *     \li binary (name ending in <tt>.bin</tt>): native 64-bit unsigned integers, in us
+ *     \li text (CSV): one record per line, whose first field is the arrival time in seconds, a non-negative
+ *         decimal number, possibly with an exponent; lines not starting with a digit, a sign or a point (headers,
+ *         comments, blank lines) are skipped, and a malformed number fails the load with <tt>EINVAL</tt>.
+ *
+ *  \param ap pointer to the arrival process
+ *  \param seed master seed of the run
+ *  \param arrival array where the arrival times (us after start of operations) are stored
+ *  \param n number of passengers
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the trace file cannot be read , holds less than <tt>n</tt> records or a malformed one (the
+ *     actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int arrivalGenerate (const ARRIVAL_PROC *ap, uint64_t seed, unsigned long arrival[], unsigned int n);
+
+/**
+ *  \brief Computation of the offered load.
+ *
+ *  \param arrival arrival times (us after start of operations)
+ *  \param n number of passengers
+ *
+ *  \return mean arrival rate between the first and the last arrival (passengers per second)
+ */
+
+extern double arrivalOfferedLoad (const unsigned long arrival[], unsigned int n);
+
+/**
+ *  \brief Computation of an absolute arrival deadline.
+ *
+ *  \param start start of operations (<tt>CLOCK_MONOTONIC</tt>)
+ *  \param us offset (us)
+ *  \param at pointer to the location where the deadline is stored
+ */
+
+extern void arrivalDeadline (const struct timespec *start, unsigned long us, struct timespec *at);
+
+/**
+ *  \brief Computation of the time elapsed since the start of operations.
+ *
+ *  \param start start of operations (<tt>CLOCK_MONOTONIC</tt>)
+ *
+ *  \return elapsed time (us)
+ */
+
+extern unsigned long elapsedSince (const struct timespec *start);
+
+/**
+ *  \brief Sleeping until an absolute deadline.
+ *
+ *  A sleep interrupted by a signal is resumed.
+ *
+ *  \param at deadline (<tt>CLOCK_MONOTONIC</tt>)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int sleepUntil (const struct timespec *at);
+
+#endif /* ARRIVALS_H_ */
@@ -0,0 +1,203 @@
+/**
+ *  \file boardingQueue.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Multi-level boarding queue.
+ *
+ *  The ids of the passengers in queue (reduced-handshake protocol) are kept in one FIFO per priority class. The next
+ *  passenger is taken from the highest class with someone waiting, unless the head of a lower class has already been
+ *  overtaken by <tt>bound</tt> passengers of higher classes, in which case that class is served first. Without
+ *  priority classes every passenger is queued in the general class and the queue is a plain FIFO.
+ *  A queue has a fixed size and is kept in the shared region; it is not synchronized, so every operation must take
+ *  place inside a critical region.
+ *
+ *  Defined operations:
+ *     \li parsing of a priority classes specification
+ *     \li initialization of a queue
+ *     \li insertion of a passenger
+ *     \li test of an empty queue
+ *     \li number of passengers in queue
+ *     \li class to be served next
+ *     \li head of a class
+ *     \li retrieval of the head of a class
+ *     \li printable name of a class.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "boardingQueue.h"
+
+/** \brief names of the priority classes */
+static const char *className[NCLASS] = {"crew", "connection", "general"};
+
+/**
+ *  \brief Parsing of a priority classes specification.
+ *
+ *  \param spec specification
+ *  \param cp pointer to the location where the priority classes are stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the specification is malformed
+ */
+
+int bqParse (const char *spec, CLASS_POLICY *cp)
+{
+    int n = 0, m = 0;                                                                     /* characters consumed */
+    int bound = STARVATION;
+
+    memset (cp, 0, sizeof (CLASS_POLICY));
+    if (sscanf (spec, "%lf:%lf%n", &cp->share[CLASS_CREW], &cp->share[CLASS_CONNECTION], &n) != 2)
+        return -1;
+    if (spec[n] == ':') {
+        if (sscanf (spec + n, ":%d%n", &bound, &m) != 1)
+            return -1;
+        n += m;
+    }
+    if (spec[n] != '\0')
+        return -1;
+    if ((cp->share[CLASS_CREW] < 0.0) || (cp->share[CLASS_CONNECTION] < 0.0) ||
+        (cp->share[CLASS_CREW] + cp->share[CLASS_CONNECTION] > 1.0) || (bound <= 0))
+        return -1;
+    cp->share[CLASS_GENERAL] = 1.0 - cp->share[CLASS_CREW] - cp->share[CLASS_CONNECTION];
+    cp->bound = (unsigned int) bound;
+
+    return 0;
+}
+
+/**
+ *  \brief Initialization of a queue.
+ *
+ *  \param q pointer to the queue
+ */
+
+void bqInit (BOARDING_QUEUE *q)
+{
+    memset (q->in, 0, sizeof (q->in));
+    memset (q->out, 0, sizeof (q->out));
+    memset (q->overtaken, 0, sizeof (q->overtaken));
+}
+
+/**
+ *  \brief Insertion of a passenger.
+ *
+ *  \param q pointer to the queue
+ *  \param id passenger id
+ *  \param cls priority class of the passenger
+ */
+
+void bqPush (BOARDING_QUEUE *q, unsigned int id, unsigned int cls)
+{
+    q->id[cls][q->in[cls]++ % N] = id;
+}
+
+/**
+ *  \brief Test of an empty queue.
+ *
+ *  \param q pointer to the queue
+ *
+ *  \return true if nobody is in queue
+ */
+
+bool bqEmpty (const BOARDING_QUEUE *q)
+{
+    unsigned int c;
+
+    for (c = 0; c < NCLASS; c++)
+        if (q->in[c] != q->out[c])
+            return false;
+    return true;
+}
+
+/**
+ *  \brief Number of passengers in queue.
+ *
+ *  \param q pointer to the queue
+ *
+ *  \return number of passengers in queue, in every class
+ */
+
+unsigned int bqLength (const BOARDING_QUEUE *q)
+{
+    unsigned int c, n = 0;
+
+    for (c = 0; c < NCLASS; c++)
+        n += q->in[c] - q->out[c];
+    return n;
+}
+
+/**
+ *  \brief Class to be served next.
+ *
+ *  \param q pointer to the queue
+ *  \param bound max number of passengers of higher classes boarded ahead of a waiting passenger, 0 for strict
+ *     priority
+ *
+ *  \return class of the next passenger to board, or -\c 1 if nobody is in queue
+ */
+
+int bqNext (const BOARDING_QUEUE *q, unsigned int bound)
+{
+    int c, next = -1;
+
+    for (c = NCLASS - 1; c >= 0; c--)                      /* the highest class waiting, unless a lower one starves */
+        if (q->in[c] != q->out[c]) {
+            if ((next != -1) && (bound > 0) && (q->overtaken[next] >= bound))
+                continue;
+            next = c;
+        }
+    return next;
+}
+
+/**
+ *  \brief Head of a class.
+ *
+ *  \param q pointer to the queue
+ *  \param cls priority class (not empty)
+ *
+ *  \return id of the first passenger in queue of the class
+ */
+
+unsigned int bqPeek (const BOARDING_QUEUE *q, unsigned int cls)
+{
+    return q->id[cls][q->out[cls] % N];
+}
+
+/**
+ *  \brief Retrieval of the head of a class.
+ *
+ *  The passengers waiting in lower classes are overtaken once more.
+ *
+ *  \param q pointer to the queue
+ *  \param cls priority class (not empty)
+ *
+ *  \return id of the passenger removed from the queue
+ */
+
+unsigned int bqPop (BOARDING_QUEUE *q, unsigned int cls)
+{
+    unsigned int c;
+
+    q->overtaken[cls] = 0;                                                   /* a new head of the class starts over */
+    for (c = cls + 1; c < NCLASS; c++)
+        if (q->in[c] != q->out[c])
+            q->overtaken[c]++;
+    return q->id[cls][q->out[cls]++ % N];
+}
+
+/**
+ *  \brief Printable name of a class.
+ *
+ *  \param cls priority class
+ *
+ *  \return name of the class
+ */
+
+const char *bqClassName (unsigned int cls)
+{
+    return (cls < NCLASS) ? className[cls] : "unknown";
+}
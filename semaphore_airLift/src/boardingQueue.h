@@ -0,0 +1,149 @@
+/**
+ *  \file boardingQueue.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Multi-level boarding queue.
+ *
+ *  The ids of the passengers in queue (reduced-handshake protocol) are kept in one FIFO per priority class. The next
+ *  passenger is taken from the highest class with someone waiting, unless the head of a lower class has already been
+ *  overtaken by <tt>bound</tt> passengers of higher classes, in which case that class is served first. Without
+ *  priority classes every passenger is queued in the general class and the queue is a plain FIFO.
+ *  A queue has a fixed size and is kept in the shared region; it is not synchronized, so every operation must take
+ *  place inside a critical region.
+ *
+ *  Defined operations:
+ *     \li parsing of a priority classes specification
+ *     \li initialization of a queue
+ *     \li insertion of a passenger
+ *     \li test of an empty queue
+ *     \li number of passengers in queue
+ *     \li class to be served next
+ *     \li head of a class
+ *     \li retrieval of the head of a class
+ *     \li printable name of a class.
+ */
+
+#ifndef BOARDINGQUEUE_H_
+#define BOARDINGQUEUE_H_
+
+#include <stdbool.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+
+/**
+ *  \brief Definition of <em>multi-level boarding queue</em> data type.
+ */
+typedef struct
+{ /** \brief ids of the passengers in queue, one ring per class */
+    unsigned int id[NCLASS][N];
+    /** \brief insertion point of each class */
+    unsigned int in[NCLASS];
+    /** \brief retrieval point of each class */
+    unsigned int out[NCLASS];
+    /** \brief number of passengers of higher classes boarded ahead of the head of each class */
+    unsigned int overtaken[NCLASS];
+} BOARDING_QUEUE;
+
+/**
+ *  \brief Parsing of a priority classes specification.
+ *
+ *  The specification is <em>crew</em><tt>:</tt><em>connection</em>[<tt>:</tt><em>bound</em>], the shares of the
+ *  passengers of the crew and connection classes (the rest are general) and the max number of passengers of higher
+ *  classes boarded ahead of a waiting passenger (STARVATION by default).
+ *
+ *  \param spec specification
+ *  \param cp pointer to the location where the priority classes are stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the specification is malformed
+ */
+
+extern int bqParse (const char *spec, CLASS_POLICY *cp);
+
+/**
+ *  \brief Initialization of a queue.
+ *
+ *  \param q pointer to the queue
+ */
+
+extern void bqInit (BOARDING_QUEUE *q);
+
+/**
+ *  \brief Insertion of a passenger.
+ *
+ *  \param q pointer to the queue
+ *  \param id passenger id
+ *  \param cls priority class of the passenger
+ */
+
+extern void bqPush (BOARDING_QUEUE *q, unsigned int id, unsigned int cls);
+
+/**
+ *  \brief Test of an empty queue.
+ *
+ *  \param q pointer to the queue
+ *
+ *  \return true if nobody is in queue
+ */
+
+extern bool bqEmpty (const BOARDING_QUEUE *q);
+
+/**
+ *  \brief Number of passengers in queue.
+ *
+ *  \param q pointer to the queue
+ *
+ *  \return number of passengers in queue, in every class
+ */
+
+extern unsigned int bqLength (const BOARDING_QUEUE *q);
+
+/**
+ *  \brief Class to be served next.
+ *
+ *  \param q pointer to the queue
+ *  \param bound max number of passengers of higher classes boarded ahead of a waiting passenger, 0 for strict
+ *     priority
+ *
+ *  \return class of the next passenger to board, or -\c 1 if nobody is in queue
+ */
+
+extern int bqNext (const BOARDING_QUEUE *q, unsigned int bound);
+
+/**
+ *  \brief Head of a class.
+ *
+ *  \param q pointer to the queue
+ *  \param cls priority class (not empty)
+ *
+ *  \return id of the first passenger in queue of the class
+ */
+
+extern unsigned int bqPeek (const BOARDING_QUEUE *q, unsigned int cls);
+
+/**
+ *  \brief Retrieval of the head of a class.
+ *
+ *  The passengers waiting in lower classes are overtaken once more.
+ *
+ *  \param q pointer to the queue
+ *  \param cls priority class (not empty)
+ *
+ *  \return id of the passenger removed from the queue
+ */
+
+extern unsigned int bqPop (BOARDING_QUEUE *q, unsigned int cls);
+
+/**
+ *  \brief Printable name of a class.
+ *
+ *  \param cls priority class
+ *
+ *  \return name of the class
+ */
+
+extern const char *bqClassName (unsigned int cls);
+
+#endif /* BOARDINGQUEUE_H_ */
@@ -0,0 +1,137 @@
+/**
+ *  \file critRegion.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Scoped critical regions with hold time measurement.
+ *
+ *  A critical region is entered by declaring a guard, which <em>down</em>s the access semaphore, and is left when the
+ *  guard goes out of scope, whatever the way out of the block (end of block, <tt>return</tt>, <tt>break</tt>), which
+ *  <em>up</em>s the semaphore. Each call site is identified by a constant label, e.g. "HT.checkPassport.count". When
+ *  a profile is in use, the time waited to get in and the time the semaphore is held are recorded in the histograms
+ *  of the call site, which are kept in the shared region and updated while the semaphore is still held: all the
+ *  guards sharing a profile must thus use the same access semaphore. An error on the semaphore operations is fatal.
+ *
+ *  Defined operations:
+ *     \li entering a critical region
+ *     \li leaving a critical region
+ *     \li profiling of the critical regions.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include "probConst.h"
+#include "semaphore.h"
+#include "histogram.h"
+#include "critRegion.h"
+
+/** \brief profile in use, if any */
+static CR_PROFILE *profile = NULL;
+
+/**
+ *  \brief Time elapsed between two instants.
+ *
+ *  \param t0 earlier instant
+ *  \param t1 later instant
+ *
+ *  \return elapsed time (ns)
+ */
+
+static unsigned long elapsed (const struct timespec *t0, const struct timespec *t1)
+{
+    return (t1->tv_sec - t0->tv_sec) * 1000000000UL + t1->tv_nsec - t0->tv_nsec;
+}
+
+/**
+ *  \brief Call site of a label, registering it if needed.
+ *
+ *  Must be called inside the critical region, which protects the profile.
+ *
+ *  \param label label of the call site
+ *
+ *  \return index of the call site in the profile, or -\c 2 if the profile is full
+ */
+
+static int siteOf (const char *label)
+{
+    unsigned int s;
+
+    for (s = 0; s < profile->nSites; s++)
+        if (strncmp (profile->site[s].label, label, CRLABEL - 1) == 0)
+            return (int) s;
+    if (s == MAXCRSITES)
+        return -2;
+    strncpy (profile->site[s].label, label, CRLABEL - 1);
+    profile->nSites++;
+
+    return (int) s;
+}
+
+/**
+ *  \brief Entering a critical region.
+ *
+ *  \param semgid semaphore set identifier
+ *  \param sem access semaphore
+ *  \param label constant label of the call site
+ *  \param site pointer to the cached index of the call site in the profile (-1 if not looked up yet)
+ *
+ *  \return guard of the critical region
+ */
+
+CR_GUARD crEnter (int semgid, unsigned int sem, const char *label, int *site)
+{
+    CR_GUARD g = {semgid, sem, label, -1};
+    struct timespec t0;
+
+    if (profile != NULL)
+        clock_gettime (CLOCK_MONOTONIC, &t0);
+    if (semDown (semgid, sem) == -1) {
+        fprintf (stderr, "error on the down operation for semaphore access (%s): %s\n", label, strerror (errno));
+        exit (EXIT_FAILURE);
+    }
+    if (profile == NULL)
+        return g;
+
+    clock_gettime (CLOCK_MONOTONIC, &g.acquired);
+    if (*site == -1)
+        *site = siteOf (label);
+    if ((g.site = *site) >= 0)
+        histRecord (&profile->site[g.site].wait, elapsed (&t0, &g.acquired));
+
+    return g;
+}
+
+/**
+ *  \brief Leaving a critical region.
+ *
+ *  \param g pointer to the guard
+ */
+
+void crLeave (CR_GUARD *g)
+{
+    struct timespec t1;
+
+    if ((profile != NULL) && (g->site >= 0)) {
+        clock_gettime (CLOCK_MONOTONIC, &t1);
+        histRecord (&profile->site[g->site].hold, elapsed (&g->acquired, &t1));
+    }
+    if (semUp (g->semgid, g->sem) == -1) {
+        fprintf (stderr, "error on the up operation for semaphore access (%s): %s\n", g->label, strerror (errno));
+        exit (EXIT_FAILURE);
+    }
+}
+
+/**
+ *  \brief Profiling of the critical regions.
+ *
+ *  \param prof pointer to the profile (\c NULL stops profiling)
+ */
+
+void crProfile (CR_PROFILE *prof)
+{
+    profile = prof;
+}
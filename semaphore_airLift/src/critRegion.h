@@ -0,0 +1,120 @@
+/**
+ *  \file critRegion.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Scoped critical regions with hold time measurement.
+ *
+ *  A critical region is entered by declaring a guard, which <em>down</em>s the access semaphore, and is left when the
+ *  guard goes out of scope, whatever the way out of the block (end of block, <tt>return</tt>, <tt>break</tt>), which
+ *  <em>up</em>s the semaphore. Each call site is identified by a constant label, e.g. "HT.checkPassport.count". When
+ *  a profile is in use, the time waited to get in and the time the semaphore is held are recorded in the histograms
+ *  of the call site, which are kept in the shared region and updated while the semaphore is still held: all the
+ *  guards sharing a profile must thus use the same access semaphore. An error on the semaphore operations is fatal.
+ *
+ *  Defined operations:
+ *     \li entering a critical region
+ *     \li leaving a critical region
+ *     \li profiling of the critical regions.
+ */
+
+#ifndef CRITREGION_H_
+#define CRITREGION_H_
+
+#include <time.h>
+
+#include "probConst.h"
+#include "histogram.h"
+
+/**
+ *  \brief Definition of <em>call site profile</em> data type.
+ */
+typedef struct
+{ /** \brief label of the call site */
+    char label[CRLABEL];
+    /** \brief time waited to enter the critical region (ns) */
+    HISTOGRAM wait;
+    /** \brief time the access semaphore was held (ns) */
+    HISTOGRAM hold;
+} CR_SITE;
+
+/**
+ *  \brief Definition of <em>critical region profile</em> data type.
+ */
+typedef struct
+{ /** \brief number of call sites registered */
+    unsigned int nSites;
+    /** \brief call sites, in order of first entry */
+    CR_SITE site[MAXCRSITES];
+} CR_PROFILE;
+
+/**
+ *  \brief Definition of <em>critical region guard</em> data type.
+ */
+typedef struct
+{ /** \brief semaphore set identifier */
+    int semgid;
+    /** \brief access semaphore */
+    unsigned int sem;
+    /** \brief label of the call site */
+    const char *label;
+    /** \brief call site in the profile (-1 if not profiled) */
+    int site;
+    /** \brief time the semaphore was acquired */
+    struct timespec acquired;
+} CR_GUARD;
+
+/** \brief token pasting, after expansion of the arguments */
+#define  CR_CAT_(a, b)               a##b
+#define  CR_CAT(a, b)                CR_CAT_(a, b)
+
+/**
+ *  \brief Critical region from here to the end of the enclosing block.
+ *
+ *  \param semgid semaphore set identifier
+ *  \param sem access semaphore
+ *  \param label constant label of the call site
+ */
+#define  CRITICAL_REGION(semgid, sem, label)                                                                         \
+    static int CR_CAT(crSite, __LINE__) = -1;                                                                        \
+    CR_GUARD CR_CAT(crGuard, __LINE__) __attribute__ ((cleanup (crLeave), unused)) =                                 \
+        crEnter ((semgid), (sem), (label), &CR_CAT(crSite, __LINE__))
+
+/**
+ *  \brief Entering a critical region.
+ *
+ *  The first entry through a call site looks its label up in the profile, registering it if needed, and caches its
+ *  index in <tt>*site</tt>; call sites beyond MAXCRSITES are not profiled.
+ *
+ *  \param semgid semaphore set identifier
+ *  \param sem access semaphore
+ *  \param label constant label of the call site
+ *  \param site pointer to the cached index of the call site in the profile (-1 if not looked up yet)
+ *
+ *  \return guard of the critical region
+ */
+
+extern CR_GUARD crEnter (int semgid, unsigned int sem, const char *label, int *site);
+
+/**
+ *  \brief Leaving a critical region.
+ *
+ *  Called when the guard goes out of scope.
+ *
+ *  \param g pointer to the guard
+ */
+
+extern void crLeave (CR_GUARD *g);
+
+/**
+ *  \brief Profiling of the critical regions.
+ *
+ *  From now on, the critical regions entered by the calling process are recorded in <tt>*prof</tt>, which may live
+ *  in a shared memory region and must have been zeroed before any process uses it.
+ *
+ *  \param prof pointer to the profile (\c NULL stops profiling)
+ */
+
+extern void crProfile (CR_PROFILE *prof);
+
+#endif /* CRITREGION_H_ */
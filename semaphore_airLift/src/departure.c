@@ -0,0 +1,125 @@
+/**
+ *  \file departure.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Departure policies of a boarding flight.
+ *
+ *  The hostess asks the policy, after checking each passenger, whether the flight must depart. Every policy makes the
+ *  flight depart when it is full or when there are no more passengers to carry. A policy may also set a max hold
+ *  time, after which the flight departs with the passengers already on board if nobody is waiting in queue.
+ *
+ *  Defined operations:
+ *     \li parsing of a departure policy specification
+ *     \li departure rule after a passenger is checked
+ *     \li max hold time of a boarding flight
+ *     \li departure rule when the hold time expires
+ *     \li printable description of a policy.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "departure.h"
+
+/**
+ *  \brief Parsing of a departure policy specification.
+ *
+ *  \param spec specification
+ *  \param dp pointer to the location where the departure policy is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the specification is malformed
+ */
+
+int departureParse (const char *spec, DEPARTURE_POLICY *dp)
+{
+    int n = 0;                                                                            /* characters consumed */
+
+    memset (dp, 0, sizeof (DEPARTURE_POLICY));
+    if (strcmp (spec, "minfc") == 0)
+        dp->kind = DEP_MINFC;
+    else if ((sscanf (spec, "hold:%lf%n", &dp->hold, &n) == 1) && (spec[n] == '\0') && (dp->hold > 0.0))
+        dp->kind = DEP_HOLD;
+    else if ((sscanf (spec, "target:%lf%n", &dp->target, &n) == 1) && (spec[n] == '\0') && (dp->target > 0.0)
+             && (dp->target <= 1.0))
+        dp->kind = DEP_TARGET;
+    else return -1;
+
+    return 0;
+}
+
+/**
+ *  \brief Departure rule after a passenger is checked.
+ *
+ *  \param dp pointer to the departure policy
+ *  \param onBoard number of passengers on board
+ *  \param inQueue number of passengers waiting in queue
+ *  \param noMore true if there are no more passengers to carry
+ *
+ *  \return true if the flight must depart
+ */
+
+bool departureDue (const DEPARTURE_POLICY *dp, unsigned int onBoard, unsigned int inQueue, bool noMore)
+{
+    unsigned int enough = MINFC;                                      /* passengers enough to leave an empty queue */
+
+    if ((onBoard >= MAXFC) || noMore)
+        return true;
+    if (dp->kind == DEP_TARGET)
+        enough = (unsigned int) ceil (dp->target * MAXFC);
+    return (onBoard >= enough) && (inQueue == 0);
+}
+
+/**
+ *  \brief Max hold time of a boarding flight.
+ *
+ *  \param dp pointer to the departure policy
+ *
+ *  \return hold time (s), or 0 if the flight waits for passengers indefinitely
+ */
+
+double departureHold (const DEPARTURE_POLICY *dp)
+{
+    return (dp->kind == DEP_HOLD) ? dp->hold : 0.0;
+}
+
+/**
+ *  \brief Departure rule when the hold time of a boarding flight expires.
+ *
+ *  \param onBoard number of passengers on board
+ *  \param inQueue number of passengers waiting in queue
+ *
+ *  \return true if the flight must depart
+ */
+
+bool departureOnHold (unsigned int onBoard, unsigned int inQueue)
+{
+    return (onBoard > 0) && (inQueue == 0);
+}
+
+/**
+ *  \brief Printable description of a policy.
+ *
+ *  \param dp pointer to the departure policy
+ *  \param buf buffer where the description is stored
+ *  \param size size of the buffer
+ *
+ *  \return <tt>buf</tt>
+ */
+
+char *departureName (const DEPARTURE_POLICY *dp, char *buf, size_t size)
+{
+    switch (dp->kind) {
+        case DEP_HOLD:   snprintf (buf, size, "hold:%g", dp->hold);
+                         break;
+        case DEP_TARGET: snprintf (buf, size, "target:%g", dp->target);
+                         break;
+        default:         snprintf (buf, size, "minfc");
+    }
+    return buf;
+}
@@ -0,0 +1,93 @@
+/**
+ *  \file departure.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Departure policies of a boarding flight.
+ *
+ *  The hostess asks the policy, after checking each passenger, whether the flight must depart. Every policy makes the
+ *  flight depart when it is full or when there are no more passengers to carry. A policy may also set a max hold
+ *  time, after which the flight departs with the passengers already on board if nobody is waiting in queue.
+ *
+ *  Defined operations:
+ *     \li parsing of a departure policy specification
+ *     \li departure rule after a passenger is checked
+ *     \li max hold time of a boarding flight
+ *     \li departure rule when the hold time expires
+ *     \li printable description of a policy.
+ */
+
+#ifndef DEPARTURE_H_
+#define DEPARTURE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "probDataStruct.h"
+
+/**
+ *  \brief Parsing of a departure policy specification.
+ *
+ *  Accepted specifications:
+ *     \li <tt>minfc</tt>: depart at MAXFC passengers, or at MINFC passengers with nobody in queue (default)
+ *     \li <tt>hold:</tt><em>secs</em>: as <tt>minfc</tt>, but once boarding has lasted <em>secs</em> the flight
+ *         departs with the passengers already on board if nobody is waiting in queue
+ *     \li <tt>target:</tt><em>u</em>: depart at MAXFC passengers, or with nobody in queue once a fraction
+ *         <em>u</em> (in (0, 1]) of the seats is taken.
+ *
+ *  \param spec specification
+ *  \param dp pointer to the location where the departure policy is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the specification is malformed
+ */
+
+extern int departureParse (const char *spec, DEPARTURE_POLICY *dp);
+
+/**
+ *  \brief Departure rule after a passenger is checked.
+ *
+ *  \param dp pointer to the departure policy
+ *  \param onBoard number of passengers on board
+ *  \param inQueue number of passengers waiting in queue
+ *  \param noMore true if there are no more passengers to carry
+ *
+ *  \return true if the flight must depart
+ */
+
+extern bool departureDue (const DEPARTURE_POLICY *dp, unsigned int onBoard, unsigned int inQueue, bool noMore);
+
+/**
+ *  \brief Max hold time of a boarding flight.
+ *
+ *  \param dp pointer to the departure policy
+ *
+ *  \return hold time (s), or 0 if the flight waits for passengers indefinitely
+ */
+
+extern double departureHold (const DEPARTURE_POLICY *dp);
+
+/**
+ *  \brief Departure rule when the hold time of a boarding flight expires.
+ *
+ *  \param onBoard number of passengers on board
+ *  \param inQueue number of passengers waiting in queue
+ *
+ *  \return true if the flight must depart
+ */
+
+extern bool departureOnHold (unsigned int onBoard, unsigned int inQueue);
+
+/**
+ *  \brief Printable description of a policy.
+ *
+ *  \param dp pointer to the departure policy
+ *  \param buf buffer where the description is stored
+ *  \param size size of the buffer
+ *
+ *  \return <tt>buf</tt>
+ */
+
+extern char *departureName (const DEPARTURE_POLICY *dp, char *buf, size_t size);
+
+#endif /* DEPARTURE_H_ */
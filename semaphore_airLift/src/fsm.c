@@ -0,0 +1,89 @@
+/**
+ *  \file fsm.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Table-driven finite-state machines.
+ *
+ *  The life cycle of an intervening entity is described by a constant table: each state has an action, which carries
+ *  out one of the operations of the entity and returns the event that took place, and each transition takes the
+ *  machine from a state to the next one upon an event, if its guard holds. The transitions of a state are tried in
+ *  order of the table, so an unguarded transition placed last acts as the default one. The engine runs the actions
+ *  until the final state is reached.
+ *
+ *  Defined operations:
+ *     \li validation of a machine
+ *     \li execution of a machine.
+ */
+
+#include <stddef.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include "fsm.h"
+
+/**
+ *  \brief Validation of a machine.
+ *
+ *  \param m pointer to the machine
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the machine is malformed (the error is reported on <tt>errno</tt> as <tt>EINVAL</tt>)
+ */
+
+int fsmCheck (const FSM *m)
+{
+    unsigned int s, t;
+    bool leaves;                                                            /* some transition leaves the state */
+
+    if ((m->initial >= m->nStates) || (m->final >= m->nStates))
+        goto malformed;
+    for (t = 0; t < m->nTrans; t++)
+        if ((m->trans[t].from >= m->nStates) || (m->trans[t].to >= m->nStates) || (m->trans[t].from == m->final))
+            goto malformed;
+    for (s = 0; s < m->nStates; s++) {
+        if (s == m->final)
+            continue;
+        for (t = 0, leaves = false; (t < m->nTrans) && !leaves; t++)
+            leaves = (m->trans[t].from == s);
+        if ((m->state[s].action == NULL) || !leaves)
+            goto malformed;
+    }
+    return 0;
+
+malformed:
+    errno = EINVAL;
+    return -1;
+}
+
+/**
+ *  \brief Execution of a machine.
+ *
+ *  \param m pointer to the machine
+ *  \param ctx context passed to the actions and guards
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when no transition leaves a state upon the event of its action (the error is reported on
+ *     <tt>errno</tt> as <tt>EPROTO</tt>)
+ */
+
+int fsmRun (const FSM *m, void *ctx)
+{
+    unsigned int s = m->initial, t;
+    int ev;                                                                   /* event returned by the action */
+
+    while (s != m->final) {
+        ev = m->state[s].action (ctx);
+        for (t = 0; t < m->nTrans; t++)
+            if ((m->trans[t].from == s) && ((m->trans[t].event == FSM_ANY) || (m->trans[t].event == ev)) &&
+                ((m->trans[t].guard == NULL) || m->trans[t].guard (ctx)))
+                break;
+        if (t == m->nTrans) {
+            errno = EPROTO;
+            return -1;
+        }
+        s = m->trans[t].to;
+    }
+
+    return 0;
+}
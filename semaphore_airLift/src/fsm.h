@@ -0,0 +1,99 @@
+/**
+ *  \file fsm.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Table-driven finite-state machines.
+ *
+ *  The life cycle of an intervening entity is described by a constant table: each state has an action, which carries
+ *  out one of the operations of the entity and returns the event that took place, and each transition takes the
+ *  machine from a state to the next one upon an event, if its guard holds. The transitions of a state are tried in
+ *  order of the table, so an unguarded transition placed last acts as the default one. The engine runs the actions
+ *  until the final state is reached.
+ *
+ *  Defined operations:
+ *     \li validation of a machine
+ *     \li execution of a machine.
+ */
+
+#ifndef FSM_H_
+#define FSM_H_
+
+#include <stdbool.h>
+
+/** \brief event matching any event returned by an action */
+#define  FSM_ANY                     -1
+
+/**
+ *  \brief Definition of <em>state</em> data type.
+ */
+typedef struct
+{ /** \brief printable name of the state */
+    const char *name;
+    /** \brief operation carried out in the state, returning the event that took place (\c NULL for the final
+               state) */
+    int (*action) (void *ctx);
+} FSM_STATE;
+
+/**
+ *  \brief Definition of <em>transition</em> data type.
+ */
+typedef struct
+{ /** \brief state the transition leaves */
+    unsigned int from;
+    /** \brief event that triggers the transition, or FSM_ANY */
+    int event;
+    /** \brief condition required for the transition to take place (\c NULL if none) */
+    bool (*guard) (void *ctx);
+    /** \brief state the transition enters */
+    unsigned int to;
+} FSM_TRANSITION;
+
+/**
+ *  \brief Definition of <em>finite-state machine</em> data type.
+ */
+typedef struct
+{ /** \brief states, indexed by state id */
+    const FSM_STATE *state;
+    /** \brief number of states */
+    unsigned int nStates;
+    /** \brief transitions, in order of precedence */
+    const FSM_TRANSITION *trans;
+    /** \brief number of transitions */
+    unsigned int nTrans;
+    /** \brief initial state */
+    unsigned int initial;
+    /** \brief final state */
+    unsigned int final;
+} FSM;
+
+/**
+ *  \brief Validation of a machine.
+ *
+ *  Every state but the final one must have an action and leave through some transition, and every transition must
+ *  join two states of the machine, not leaving the final one.
+ *
+ *  \param m pointer to the machine
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the machine is malformed (the error is reported on <tt>errno</tt> as <tt>EINVAL</tt>)
+ */
+
+extern int fsmCheck (const FSM *m);
+
+/**
+ *  \brief Execution of a machine.
+ *
+ *  The actions are run from the initial state until the final state is reached.
+ *
+ *  \param m pointer to the machine
+ *  \param ctx context passed to the actions and guards
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when no transition leaves a state upon the event of its action (the error is reported on
+ *     <tt>errno</tt> as <tt>EPROTO</tt>)
+ */
+
+extern int fsmRun (const FSM *m, void *ctx);
+
+#endif /* FSM_H_ */
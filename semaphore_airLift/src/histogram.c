@@ -0,0 +1,122 @@
+/**
+ *  \file histogram.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Latency histograms.
+ *
+ *  Values (in us) are counted in log-linear bins: exact up to 15 us, then 16 bins per power of two, so the relative
+ *  error of a percentile is below 1/16. A histogram has a fixed size and may be kept in the shared region; it is
+ *  not synchronized, so concurrent recording must take place inside a critical region.
+ *
+ *  Defined operations:
+ *     \li recording of a value
+ *     \li mean of the recorded values
+ *     \li percentile of the recorded values.
+ */
+
+#include <math.h>
+
+#include "probConst.h"
+#include "histogram.h"
+
+/** \brief number of bins per power of two (and of exact bins) */
+#define  SUB      16
+
+/** \brief log2 of SUB */
+#define  SUBBITS   4
+
+/**
+ *  \brief Bin of a value.
+ *
+ *  \param us value (us)
+ *
+ *  \return bin index (values beyond the range are counted in the last bin)
+ */
+
+static unsigned int binOf (unsigned long us)
+{
+    unsigned int e, b;                                                         /* exponent of the value, bin index */
+
+    if (us < SUB)
+        return (unsigned int) us;
+    e = 63 - __builtin_clzl (us);
+    b = (e - SUBBITS + 1) * SUB + (unsigned int) ((us >> (e - SUBBITS)) - SUB);
+    return (b < HISTBINS) ? b : HISTBINS - 1;
+}
+
+/**
+ *  \brief Midpoint of a bin.
+ *
+ *  \param b bin index
+ *
+ *  \return midpoint of the values counted in the bin (us)
+ */
+
+static double binMid (unsigned int b)
+{
+    unsigned int e;                                                                       /* exponent of the bin */
+
+    if (b < SUB)
+        return b;
+    e = b / SUB + SUBBITS - 1;
+    return ldexp (SUB + b % SUB + 0.5, e - SUBBITS);
+}
+
+/**
+ *  \brief Recording of a value.
+ *
+ *  \param h pointer to the histogram
+ *  \param us value (us)
+ */
+
+void histRecord (HISTOGRAM *h, unsigned long us)
+{
+    h->bin[binOf (us)] += 1;
+    h->count += 1;
+    h->sum += us;
+    if (us > h->max)
+        h->max = us;
+}
+
+/**
+ *  \brief Mean of the recorded values.
+ *
+ *  \param h pointer to the histogram
+ *
+ *  \return mean (us), or 0 if no value was recorded
+ */
+
+double histMean (const HISTOGRAM *h)
+{
+    return (h->count > 0) ? h->sum / h->count : 0.0;
+}
+
+/**
+ *  \brief Percentile of the recorded values.
+ *
+ *  \param h pointer to the histogram
+ *  \param q quantile, in [0, 1]
+ *
+ *  \return midpoint of the bin holding the percentile (us), or 0 if no value was recorded
+ */
+
+double histPercentile (const HISTOGRAM *h, double q)
+{
+    unsigned long rank, seen = 0;                                          /* rank of the percentile, values seen */
+    unsigned int b;
+
+    if (h->count == 0)
+        return 0.0;
+    rank = (unsigned long) ceil (q * h->count);
+    if (rank == 0)
+        rank = 1;
+    for (b = 0; b < HISTBINS; b++) {
+        seen += h->bin[b];
+        if (seen >= rank)
+            break;
+    }
+    if (b >= HISTBINS)
+        b = HISTBINS - 1;
+    return (binMid (b) < h->max) ? binMid (b) : h->max;
+}
@@ -0,0 +1,67 @@
+/**
+ *  \file histogram.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Latency histograms.
+ *
+ *  Values (in us) are counted in log-linear bins: exact up to 15 us, then 16 bins per power of two, so the relative
+ *  error of a percentile is below 1/16. A histogram has a fixed size and may be kept in the shared region; it is
+ *  not synchronized, so concurrent recording must take place inside a critical region.
+ *
+ *  Defined operations:
+ *     \li recording of a value
+ *     \li mean of the recorded values
+ *     \li percentile of the recorded values.
+ */
+
+#ifndef HISTOGRAM_H_
+#define HISTOGRAM_H_
+
+#include "probConst.h"
+
+/**
+ *  \brief Definition of <em>latency histogram</em> data type.
+ */
+typedef struct
+{ /** \brief number of values recorded */
+    unsigned long count;
+    /** \brief sum of the values recorded (us) */
+    double sum;
+    /** \brief largest value recorded (us) */
+    unsigned long max;
+    /** \brief number of values recorded in each bin */
+    unsigned int bin[HISTBINS];
+} HISTOGRAM;
+
+/**
+ *  \brief Recording of a value.
+ *
+ *  \param h pointer to the histogram
+ *  \param us value (us)
+ */
+
+extern void histRecord (HISTOGRAM *h, unsigned long us);
+
+/**
+ *  \brief Mean of the recorded values.
+ *
+ *  \param h pointer to the histogram
+ *
+ *  \return mean (us), or 0 if no value was recorded
+ */
+
+extern double histMean (const HISTOGRAM *h);
+
+/**
+ *  \brief Percentile of the recorded values.
+ *
+ *  \param h pointer to the histogram
+ *  \param q quantile, in [0, 1]
+ *
+ *  \return midpoint of the bin holding the percentile (us), or 0 if no value was recorded
+ */
+
+extern double histPercentile (const HISTOGRAM *h, double q);
+
+#endif /* HISTOGRAM_H_ */
@@ -8,11 +8,20 @@
  *  Defined operations:
  *     \li file initialization
  *     \li writing the start of boarding at the end of the file
+ *     \li writing the passport pre-check of a passenger at the end of the file
  *     \li writing the start of flight at end of the file.
  *     \li writing the present full state as a single line at the end of the file.
  *     \li Writing the flight arrival at the end of the file.
  *     \li Writing the flight returning at the end of the file.
- *     \li writing summary of air lift at the end of the file.
+ *     \li writing summary of air lift at the end of the file
+ *     \li writing the service mode throughput at the end of the file
+ *     \li writing the offered load and achieved throughput at the end of the file
+ *     \li writing the number of semaphore operations at the end of the file
+ *     \li writing the number of messages sent at the end of the file
+ *     \li writing the critical region profile at the end of the file
+ *     \li writing the scheduling policy applied at the end of the file
+ *     \li writing the departure policy and the passengers waiting time at the end of the file
+ *     \li writing the abort of a stalled run at the end of the file.
  *
  *  \author Nuno Lau - January 2022
  */
@@ -28,6 +37,11 @@
 
 #include "probConst.h"
 #include "probDataStruct.h"
+#include "schedPolicy.h"
+#include "departure.h"
+#include "histogram.h"
+#include "critRegion.h"
+#include "boardingQueue.h"
 
 static FILE *openLog(char nFic[], char mode[])
 {
@@ -59,10 +73,51 @@ static void closeLog(FILE *fic)
     }
 }
 
-static void printHeader(FILE *fic)
+/** \brief room for the state line: the widest field of an int takes 11 characters */
+#define  STATELINE    (11 * (MAXPL + MAXHT + N + 3) + 3)
+
+/**
+ *  \brief Formatting of a field of the state line.
+ *
+ *  Same output as <tt>"%*d"</tt>, without going through the <tt>printf</tt> machinery for the small values that
+ *  make up nearly all of the line.
+ *
+ *  \param l location where the field is written
+ *  \param width min width of the field, right-aligned (3 or 4)
+ *  \param v value of the field
+ *
+ *  \return location following the field
+ */
+
+static char *putField(char *l, int width, int v)
 {
-    fprintf(fic,"%3s","PT");
-    fprintf(fic,"%3s","HT");
+    if ((v < 0) || (v > 999))
+        return l + sprintf(l, "%*d", width, v);
+
+    char *e = l + width;
+    do {
+        *--e = '0' + v % 10;
+        v /= 10;
+    } while (v > 0);
+    while (e > l)
+        *--e = ' ';
+    return l + width;
+}
+
+static void printHeader(FILE *fic, FULL_STAT *p_fSt)
+{
+    if (p_fSt->par.nPlanes > 1) {
+        unsigned int t;
+        for (t = 0; t < p_fSt->par.nPlanes; t++)
+            fprintf(fic," PT%u",t);
+    }
+    else fprintf(fic,"%3s","PT");
+    if (p_fSt->par.nHostess > 1) {
+        unsigned int h;
+        for (h = 0; h < p_fSt->par.nHostess; h++)
+            fprintf(fic," H%u",h);
+    }
+    else fprintf(fic,"%3s","HT");
     fprintf(fic," ");
     int p;
     for(p=0; p < N; p++) {
@@ -77,6 +132,18 @@ static void printHeader(FILE *fic)
     fprintf(fic,"\n");
 }
 
+/* Plane and destination of a flight, appended to the announcements when there are several of them */
+static void printPlane(FILE *fic, FULL_STAT *p_fSt, unsigned int plane, unsigned int dest)
+{
+    if ((p_fSt->par.nPlanes > 1) && (p_fSt->par.nDest > 1))
+        fprintf(fic," (plane %u, destination %u)", plane, dest);
+    else if (p_fSt->par.nPlanes > 1)
+        fprintf(fic," (plane %u)", plane);
+    else if (p_fSt->par.nDest > 1)
+        fprintf(fic," (destination %u)", dest);
+    fprintf(fic,"\n");
+}
+
 /**
  *  \brief File initialization.
  *
@@ -85,12 +152,15 @@ static void printHeader(FILE *fic)
  *
  *  The file header consists of
  *       \li a title line
+ *       \li a blank line
+ *       \li the master seed of the run
  *       \li a blank line.
  *
  *  \param nFic name of the logging file
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
  */
 
-void createLog (char nFic[])
+void createLog (char nFic[], FULL_STAT *p_fSt)
 {
     FILE *fic;                                                                                      /* file descriptor */
 
@@ -99,7 +169,8 @@ void createLog (char nFic[])
     /* title line + blank line */
 
     fprintf (fic, "%31cAir Lift - Description of the internal state\n\n", ' ');
-    printHeader(fic);
+    fprintf (fic, "Master seed: %llu\n\n", (unsigned long long) p_fSt->par.seed);
+    printHeader(fic, p_fSt);
 
     closeLog(fic);
 }
@@ -110,7 +181,7 @@ void createLog (char nFic[])
  *  If <tt>nFic</tt> is a null pointer or a null string, the lines written to stdout
  *
  *  The following layout is obeyed for the full state in a single line
- *    \li pilot state
+ *    \li pilot state (one per plane when there are several planes)
  *    \li hostess state 
  *    \li passengers state 
  *    \li number of passengers waiting and flying
@@ -122,24 +193,33 @@ void createLog (char nFic[])
 void saveState (char nFic[], FULL_STAT *p_fSt)
 {
     FILE *fic;                                                                                      /* file descriptor */
+    char line[STATELINE];                                               /* the line is formatted here and written once */
+    char *l = line;
 
-    fic = openLog(nFic,"a");
-
-    fprintf(fic,"%3d",p_fSt->st.pilotStat);
-    fprintf(fic,"%3d",p_fSt->st.hostessStat);
-    fprintf(fic," ");
+    unsigned int t;
+    if (p_fSt->par.nPlanes > 1) {
+        for (t = 0; t < p_fSt->par.nPlanes; t++)
+            l = putField(l,4,p_fSt->st.pilotStat[t]);
+    }
+    else l = putField(l,3,p_fSt->st.pilotStat[0]);
+    unsigned int h;
+    for (h = 0; (h == 0) || (h < p_fSt->par.nHostess); h++)
+        l = putField(l,3,p_fSt->st.hostessStat[h]);
+    *l++ = ' ';
     int p;
     for(p=0; p < N; p++) {
-        fprintf(fic,"%4d",p_fSt->st.passengerStat[p]);
+        l = putField(l,4,p_fSt->st.passengerStat[p]);
     }
 
-    fprintf(fic," ");
-    fprintf(fic,"%4d",p_fSt->nPassInQueue);
-    fprintf(fic,"%4d",p_fSt->nPassInFlight);
-    fprintf(fic,"%4d",p_fSt->totalPassBoarded);
+    *l++ = ' ';
+    l = putField(l,4,p_fSt->nPassInQueue);
+    l = putField(l,4,p_fSt->nPassInFlight);
+    l = putField(l,4,p_fSt->totalPassBoarded);
 
-    fprintf(fic,"\n");
+    *l++ = '\n';
 
+    fic = openLog(nFic,"a");
+    fwrite(line, 1, l - line, fic);
     closeLog(fic);
 }
 /**
@@ -157,8 +237,9 @@ void saveStartBoarding (char nFic[], FULL_STAT *p_fSt)
 
     fic = openLog(nFic,"a");
 
-    fprintf(fic,"Flight %d : Boarding Started\n", p_fSt->nFlight);
-    printHeader(fic);
+    fprintf(fic,"Flight %d : Boarding Started", p_fSt->nFlight);
+    printPlane(fic, p_fSt, p_fSt->atGate, p_fSt->plane[p_fSt->atGate].dest);
+    printHeader(fic, p_fSt);
 
 
     closeLog(fic);
@@ -184,6 +265,26 @@ void savePassengerChecked (char nFic[], FULL_STAT *p_fSt)
     closeLog(fic);
 }
 
+/**
+ *  \brief Writing the passport pre-check of a passenger, while the plane is away, at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ */
+
+void savePassengerPreChecked (char nFic[], FULL_STAT *p_fSt)
+{
+    FILE *fic;                                                                                      /* file descriptor */
+
+    fic = openLog(nFic,"a");
+
+    fprintf(fic,"Flight %d : Passenger %d pre-checked\n", p_fSt->nFlight + 1, p_fSt->passengerChecked);
+
+    closeLog(fic);
+}
+
 /**
  *  \brief Writing the start of flight at end of the file.
  *
@@ -199,8 +300,9 @@ void saveFlightDeparted (char nFic[], FULL_STAT *p_fSt)
 
     fic = openLog(nFic,"a");
 
-    fprintf(fic,"Flight %d : Departed with %d passengers\n", p_fSt->nFlight, p_fSt->nPassengersInFlight[p_fSt->nFlight-1]);
-    printHeader(fic);
+    fprintf(fic,"Flight %d : Departed with %d passengers", p_fSt->nFlight, p_fSt->nPassengersInFlight[(p_fSt->nFlight-1) % MAXNF]);
+    printPlane(fic, p_fSt, p_fSt->atGate, p_fSt->plane[p_fSt->atGate].dest);
+    printHeader(fic, p_fSt);
 
     closeLog(fic);
 }
@@ -213,16 +315,18 @@ void saveFlightDeparted (char nFic[], FULL_STAT *p_fSt)
  *
  *  \param nFic name of the logging file
  *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param plane plane that arrived
  */
 
-void saveFlightArrived (char nFic[], FULL_STAT *p_fSt)
+void saveFlightArrived (char nFic[], FULL_STAT *p_fSt, unsigned int plane)
 {
     FILE *fic;                                                                                      /* file descriptor */
 
     fic = openLog(nFic,"a");
 
-    fprintf(fic,"Flight %d : Arrived \n", p_fSt->nFlight);
-    printHeader(fic);
+    fprintf(fic,"Flight %d : Arrived%s", p_fSt->plane[plane].flight, (p_fSt->par.nPlanes > 1) ? "" : " ");
+    printPlane(fic, p_fSt, plane, p_fSt->plane[plane].dest);
+    printHeader(fic, p_fSt);
 
     closeLog(fic);
 }
@@ -234,16 +338,18 @@ void saveFlightArrived (char nFic[], FULL_STAT *p_fSt)
  *
  *  \param nFic name of the logging file
  *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param plane plane that is returning
  */
 
-void saveFlightReturning (char nFic[], FULL_STAT *p_fSt)
+void saveFlightReturning (char nFic[], FULL_STAT *p_fSt, unsigned int plane)
 {
     FILE *fic;                                                                                      /* file descriptor */
 
     fic = openLog(nFic,"a");
 
-    fprintf(fic,"Flight %d : Returning \n", p_fSt->nFlight);
-    printHeader(fic);
+    fprintf(fic,"Flight %d : Returning%s", p_fSt->plane[plane].flight, (p_fSt->par.nPlanes > 1) ? "" : " ");
+    printPlane(fic, p_fSt, plane, p_fSt->plane[plane].dest);
+    printHeader(fic, p_fSt);
 
     closeLog(fic);
 }
@@ -253,6 +359,9 @@ void saveFlightReturning (char nFic[], FULL_STAT *p_fSt)
  *
  *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout 
  *
+ *  When there are several planes, each flight is listed with its plane, followed by the totals of each plane. When
+ *  there are several destinations, each flight is also listed with its destination.
+ *
  *  \param nFic name of the logging file
  *  \param p_fSt pointer to the location where the full internal state of the problem is stored
  */
@@ -266,9 +375,286 @@ void saveAirLiftResult (char nFic[], FULL_STAT *p_fSt)
 
     int f;
     fprintf(fic,"AirLift used %d Flights\n", p_fSt->nFlight);
-    for(f=0; f<p_fSt->nFlight; f++) {
-        fprintf(fic,"Flight %d took %2d passengers\n", f+1, p_fSt->nPassengersInFlight[f]);
+    if (p_fSt->nFlight > 0) {
+        fprintf(fic,"Mean flight utilisation %.1f%%\n", 100.0 * p_fSt->totalPassBoarded / (p_fSt->nFlight * MAXFC));
+    }
+    for(f=(p_fSt->nFlight > MAXNF) ? p_fSt->nFlight-MAXNF : 0; f<p_fSt->nFlight; f++) {
+        fprintf(fic,"Flight %d took %2d passengers", f+1, p_fSt->nPassengersInFlight[f % MAXNF]);
+        printPlane(fic, p_fSt, p_fSt->flightPlane[f % MAXNF], p_fSt->flightDest[f % MAXNF]);
+    }
+    if (p_fSt->par.nPlanes > 1) {
+        unsigned int t;
+        for (t = 0; t < p_fSt->par.nPlanes; t++)
+            fprintf(fic,"Plane %u made %u flights with %u passengers\n", t, p_fSt->plane[t].nFlights,
+                    p_fSt->plane[t].nCarried);
+    }
+
+    closeLog(fic);
+}
+
+/**
+ *  \brief Writing the routing policy and the throughput to each destination at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param t duration of the run (s)
+ */
+
+void saveRoutes (char nFic[], FULL_STAT *p_fSt, double t)
+{
+    FILE *fic;                                                                                      /* file descriptor */
+    unsigned int d;
+
+    fic = openLog(nFic,"a");
+
+    fprintf(fic,"Routing policy %s : %u flights to %u destinations\n",
+            (p_fSt->par.routing == ROUTE_CYCLIC) ? "cyclic" : "longest", p_fSt->nFlight, p_fSt->par.nDest);
+    for (d = 0; d < p_fSt->par.nDest; d++)
+        fprintf(fic,"Destination %u : %u flights with %u passengers, %.2f passengers/s\n", d,
+                p_fSt->route[d].nFlights, p_fSt->route[d].nBoarded, (t > 0.0) ? p_fSt->route[d].nBoarded / t : 0.0);
+
+    closeLog(fic);
+}
+
+/**
+ *  \brief Writing the service mode throughput at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param t elapsed time since start of service (s)
+ *  \param passRate passengers boarded per second since the previous report
+ *  \param flightRate flights per second since the previous report
+ */
+
+void saveThroughput (char nFic[], double t, double passRate, double flightRate)
+{
+    FILE *fic;                                                                                      /* file descriptor */
+
+    fic = openLog(nFic,"a");
+
+    fprintf(fic,"Service %8.2f s : %9.2f passengers/s %7.2f flights/s\n", t, passRate, flightRate);
+
+    closeLog(fic);
+}
+
+/**
+ *  \brief Writing the service mode steady-state throughput at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param t duration of the steady-state period (s)
+ *  \param passRate passengers boarded per second
+ *  \param flightRate flights per second
+ */
+
+void saveSteadyState (char nFic[], double t, double passRate, double flightRate)
+{
+    FILE *fic;                                                                                      /* file descriptor */
+
+    fic = openLog(nFic,"a");
+
+    fprintf(fic,"Steady state over %.2f s : %.2f passengers/s %.2f flights/s\n", t, passRate, flightRate);
+
+    closeLog(fic);
+}
+
+/**
+ *  \brief Writing the offered load and achieved throughput at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param offered offered load of the arrival process (passengers per second)
+ *  \param achieved achieved throughput (passengers boarded per second)
+ *  \param makespan duration of the run (s)
+ */
+
+void saveLoad (char nFic[], double offered, double achieved, double makespan)
+{
+    FILE *fic;                                                                                      /* file descriptor */
+
+    fic = openLog(nFic,"a");
+
+    fprintf(fic,"Offered load %.2f passengers/s, achieved throughput %.2f passengers/s over %.3f s\n",
+            offered, achieved, makespan);
+
+    closeLog(fic);
+}
+
+/**
+ *  \brief Writing the number of semaphore operations at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param ops number of down and up operations carried out by the intervening entities
+ *  \param boarded number of passengers boarded
+ */
+
+void saveSemOps (char nFic[], unsigned long ops, unsigned int boarded)
+{
+    FILE *fic;                                                                                      /* file descriptor */
+
+    fic = openLog(nFic,"a");
+
+    fprintf(fic,"Semaphore operations : %lu, %.2f per boarded passenger\n", ops,
+            (boarded > 0) ? (double) ops / boarded : 0.0);
+
+    closeLog(fic);
+}
+
+/**
+ *  \brief Writing the number of messages sent at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param msgs number of messages sent by the intervening entities
+ *  \param boarded number of passengers boarded
+ */
+
+void saveMessages (char nFic[], unsigned long msgs, unsigned int boarded)
+{
+    FILE *fic;                                                                                      /* file descriptor */
+
+    fic = openLog(nFic,"a");
+
+    fprintf(fic,"Messages sent : %lu, %.2f per boarded passenger\n", msgs,
+            (boarded > 0) ? (double) msgs / boarded : 0.0);
+
+    closeLog(fic);
+}
+
+/**
+ *  \brief Writing the critical region profile at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param prof pointer to the time waited for and held in the critical regions, per call site
+ */
+
+void saveCritRegions (char nFic[], const CR_PROFILE *prof)
+{
+    FILE *fic;                                                                                      /* file descriptor */
+    unsigned int s;
+
+    fic = openLog(nFic,"a");
+
+    fprintf(fic,"Critical regions (us) :\n");
+    fprintf(fic,"  %-32s %8s %9s %9s %9s %9s %9s %9s\n", "site", "entries", "wait p50", "wait p99", "wait max",
+            "hold p50", "hold p99", "hold max");
+    for (s = 0; s < prof->nSites; s++)
+        fprintf(fic,"  %-32s %8lu %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f\n", prof->site[s].label, prof->site[s].hold.count,
+                histPercentile(&prof->site[s].wait, 0.50) / 1000.0, histPercentile(&prof->site[s].wait, 0.99) / 1000.0,
+                prof->site[s].wait.max / 1000.0, histPercentile(&prof->site[s].hold, 0.50) / 1000.0,
+                histPercentile(&prof->site[s].hold, 0.99) / 1000.0, prof->site[s].hold.max / 1000.0);
+
+    closeLog(fic);
+}
+
+/**
+ *  \brief Writing the scheduling policy applied at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param sp scheduling policy of the run
+ */
+
+void savePolicy (char nFic[], SCHED_POLICY *sp)
+{
+    static const char *roles[] = {"pilot", "hostess", "passengers"};
+    FILE *fic;                                                                                      /* file descriptor */
+    unsigned int r;
+
+    fic = openLog(nFic,"a");
+
+    fprintf(fic,"Scheduling policy :");
+    for (r = 0; r < 3; r++) {
+        fprintf(fic," %s cpus %s", roles[r], (sp->cpus[r][0] != '\0') ? sp->cpus[r] : "all");
+        if (r < 2) {
+            fprintf(fic," %s", policyName(sp->applied[r]));
+            if (sp->applied[r] != sp->prio)
+                fprintf(fic," (%s requested)", policyName(sp->prio));
+        }
+        fprintf(fic,"%s", (r < 2) ? "," : "\n");
     }
 
     closeLog(fic);
 }
+
+/**
+ *  \brief Writing the departure policy and the passengers waiting time at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param dp pointer to the departure policy of the run
+ *  \param wait pointer to the histogram of the passengers waiting time
+ */
+
+void saveWaits (char nFic[], DEPARTURE_POLICY *dp, HISTOGRAM *wait)
+{
+    FILE *fic;                                                                                      /* file descriptor */
+    char name[32];
+
+    fic = openLog(nFic,"a");
+
+    fprintf(fic,"Departure policy %s : passenger wait mean %.3f ms, p99 %.3f ms over %lu trips\n",
+            departureName(dp, name, sizeof(name)), histMean(wait) / 1000.0, histPercentile(wait, 0.99) / 1000.0,
+            wait->count);
+
+    closeLog(fic);
+}
+
+/**
+ *  \brief Writing the queue waiting time of each priority class at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param cp pointer to the priority classes of the run
+ *  \param wait histograms of the queue waiting time, one per class
+ */
+
+void saveClassWaits (char nFic[], CLASS_POLICY *cp, HISTOGRAM wait[])
+{
+    FILE *fic;                                                                                      /* file descriptor */
+    unsigned int c;
+
+    fic = openLog(nFic,"a");
+
+    fprintf(fic,"Priority classes (starvation bound %u) :\n", cp->bound);
+    for (c = 0; c < NCLASS; c++)
+        fprintf(fic,"  %-10s %5.1f%% : queue wait p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms over %lu trips\n",
+                bqClassName(c), 100.0 * cp->share[c], histPercentile(&wait[c], 0.50) / 1000.0,
+                histPercentile(&wait[c], 0.90) / 1000.0, histPercentile(&wait[c], 0.99) / 1000.0,
+                wait[c].max / 1000.0, wait[c].count);
+
+    closeLog(fic);
+}
+
+/**
+ *  \brief Writing the abort of a stalled run at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param stalled time without progress (s)
+ */
+
+void saveStall (char nFic[], double stalled)
+{
+    FILE *fic;                                                                                      /* file descriptor */
+
+    fic = openLog(nFic,"a");
+
+    fprintf(fic,"Watchdog : no progress for %.2f s, run aborted (snapshot in error_WD)\n", stalled);
+
+    closeLog(fic);
+}
@@ -12,7 +12,14 @@
  *     \li writing the present full state as a single line at the end of the file.
  *     \li Writing the flight arrival at the end of the file.
  *     \li Writing the flight returning at the end of the file.
- *     \li writing summary of air lift at the end of the file.
+ *     \li writing summary of air lift at the end of the file
+ *     \li writing the service mode throughput at the end of the file
+ *     \li writing the offered load and achieved throughput at the end of the file
+ *     \li writing the number of semaphore operations at the end of the file
+ *     \li writing the number of messages sent at the end of the file
+ *     \li writing the critical region profile at the end of the file
+ *     \li writing the scheduling policy applied at the end of the file
+ *     \li writing the abort of a stalled run at the end of the file.
  *
  *  \author Nuno Lau - January 2022
  */
@@ -21,6 +28,8 @@
 #define LOGGING_H_
 
 #include "probDataStruct.h"
+#include "histogram.h"
+#include "critRegion.h"
 
 /**
  *  \brief File initialization.
@@ -30,12 +39,15 @@
  *
  *  The file header consists of
  *       \li a title line
+ *       \li a blank line
+ *       \li the master seed of the run
  *       \li a blank line.
  *
  *  \param nFic name of the logging file
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
  */
 
-extern void createLog (char nFic[]);
+extern void createLog (char nFic[], FULL_STAT *p_fSt);
 
 /**
  *  \brief Writing the start of Boarding Process and header.
@@ -83,9 +95,10 @@ extern void saveState (char nFic[], FULL_STAT *p_fSt);
  *
  *  \param nFic name of the logging file
  *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param plane plane that arrived
  */
 
-extern void saveFlightArrived (char nFic[], FULL_STAT *p_fSt);
+extern void saveFlightArrived (char nFic[], FULL_STAT *p_fSt, unsigned int plane);
 
 /**
  *  \brief Writing the flight returning at the end of the file.
@@ -94,9 +107,10 @@ extern void saveFlightArrived (char nFic[], FULL_STAT *p_fSt);
  *
  *  \param nFic name of the logging file
  *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param plane plane that is returning
  */
 
-extern void saveFlightReturning (char nFic[], FULL_STAT *p_fSt);
+extern void saveFlightReturning (char nFic[], FULL_STAT *p_fSt, unsigned int plane);
 
 /**
  *  \brief Writing the start of Boarding Process and header.
@@ -109,6 +123,17 @@ extern void saveFlightReturning (char nFic[], FULL_STAT *p_fSt);
 
 void savePassengerChecked (char nFic[], FULL_STAT *p_fSt);
 
+/**
+ *  \brief Writing the passport pre-check of a passenger, while the plane is away, at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ */
+
+extern void savePassengerPreChecked (char nFic[], FULL_STAT *p_fSt);
+
 /**
  *  \brief Writing summary of air lift at the end of the file.
  *
@@ -120,4 +145,136 @@ void savePassengerChecked (char nFic[], FULL_STAT *p_fSt);
 
 extern void saveAirLiftResult (char nFic[], FULL_STAT *p_fSt);
 
+/**
+ *  \brief Writing the routing policy and the throughput to each destination at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param t duration of the run (s)
+ */
+
+extern void saveRoutes (char nFic[], FULL_STAT *p_fSt, double t);
+
+/**
+ *  \brief Writing the service mode throughput at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param t elapsed time since start of service (s)
+ *  \param passRate passengers boarded per second since the previous report
+ *  \param flightRate flights per second since the previous report
+ */
+
+extern void saveThroughput (char nFic[], double t, double passRate, double flightRate);
+
+/**
+ *  \brief Writing the service mode steady-state throughput at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param t duration of the steady-state period (s)
+ *  \param passRate passengers boarded per second
+ *  \param flightRate flights per second
+ */
+
+extern void saveSteadyState (char nFic[], double t, double passRate, double flightRate);
+
+/**
+ *  \brief Writing the offered load and achieved throughput at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param offered offered load of the arrival process (passengers per second)
+ *  \param achieved achieved throughput (passengers boarded per second)
+ *  \param makespan duration of the run (s)
+ */
+
+extern void saveLoad (char nFic[], double offered, double achieved, double makespan);
+
+/**
+ *  \brief Writing the number of semaphore operations at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param ops number of down and up operations carried out by the intervening entities
+ *  \param boarded number of passengers boarded
+ */
+
+extern void saveSemOps (char nFic[], unsigned long ops, unsigned int boarded);
+
+/**
+ *  \brief Writing the number of messages sent at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param msgs number of messages sent by the intervening entities
+ *  \param boarded number of passengers boarded
+ */
+
+extern void saveMessages (char nFic[], unsigned long msgs, unsigned int boarded);
+
+/**
+ *  \brief Writing the critical region profile at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param prof pointer to the time waited for and held in the critical regions, per call site
+ */
+
+extern void saveCritRegions (char nFic[], const CR_PROFILE *prof);
+
+/**
+ *  \brief Writing the scheduling policy applied at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param sp scheduling policy of the run
+ */
+
+extern void savePolicy (char nFic[], SCHED_POLICY *sp);
+
+/**
+ *  \brief Writing the abort of a stalled run at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param stalled time without progress (s)
+ */
+
+extern void saveStall (char nFic[], double stalled);
+
+/**
+ *  \brief Writing the departure policy and the passengers waiting time at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param dp pointer to the departure policy of the run
+ *  \param wait pointer to the histogram of the passengers waiting time
+ */
+
+extern void saveWaits (char nFic[], DEPARTURE_POLICY *dp, HISTOGRAM *wait);
+
+/**
+ *  \brief Writing the queue waiting time of each priority class at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param cp pointer to the priority classes of the run
+ *  \param wait histograms of the queue waiting time, one per class
+ */
+
+extern void saveClassWaits (char nFic[], CLASS_POLICY *cp, HISTOGRAM wait[]);
+
 #endif /* LOGGING_H_ */
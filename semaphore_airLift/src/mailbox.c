@@ -0,0 +1,162 @@
+/**
+ *  \file mailbox.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Single-producer/single-consumer mailboxes of small messages.
+ *
+ *  A mailbox is a bounded ring of messages kept in the shared region, with the index of the next message to be sent
+ *  doubling as a futex doorbell: the receiver sleeps on it while the mailbox is empty and the sender only issues a
+ *  wakeup when the receiver is asleep. Only one process may send at a time and only one may receive; several
+ *  processes may take turns as the sender as long as each turn follows the previous one (e.g. it is started by a
+ *  message the previous sender sent).
+ *
+ *  Defined operations:
+ *     \li initialization of a mailbox
+ *     \li sending of a message
+ *     \li reception of a message
+ *     \li reception of a message of a given type
+ *     \li counting of the messages sent.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "probConst.h"
+#include "mailbox.h"
+
+/** \brief counter of the messages sent, if any */
+static unsigned long *msgCount = NULL;
+
+/**
+ *  \brief Futex operation on a word of the shared region.
+ *
+ *  The operations are not private to the process, since the word is shared by several processes.
+ *
+ *  \param word pointer to the futex word
+ *  \param op <tt>FUTEX_WAIT</tt> or <tt>FUTEX_WAKE</tt>
+ *  \param val value the word must hold to wait, or max number of processes to wake up
+ *
+ *  \return as the <tt>futex</tt> system call
+ */
+
+static long futex (unsigned int *word, int op, unsigned int val)
+{
+    return syscall (SYS_futex, word, op, val, NULL, NULL, 0);
+}
+
+/**
+ *  \brief Initialization of a mailbox.
+ *
+ *  \param mb pointer to the mailbox
+ */
+
+void mbInit (MAILBOX *mb)
+{
+    mb->head = mb->tail = 0;
+    mb->sleeping = 0;
+}
+
+/**
+ *  \brief Sending of a message.
+ *
+ *  \param mb pointer to the mailbox
+ *  \param type message type
+ *  \param arg argument of the message
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>; <tt>EAGAIN</tt> if the
+ *     mailbox is full)
+ */
+
+int mbSend (MAILBOX *mb, unsigned int type, unsigned int arg)
+{
+    unsigned int t = __atomic_load_n (&mb->tail, __ATOMIC_RELAXED);              /* only the sender moves the tail */
+
+    if (t - __atomic_load_n (&mb->head, __ATOMIC_ACQUIRE) == MBOXSIZE) {
+        errno = EAGAIN;
+        return -1;
+    }
+    mb->msg[t % MBOXSIZE].type = type;
+    mb->msg[t % MBOXSIZE].arg = arg;
+    if (msgCount != NULL)
+        __atomic_fetch_add (msgCount, 1, __ATOMIC_RELAXED);
+    __atomic_store_n (&mb->tail, t + 1, __ATOMIC_SEQ_CST);                                   /* publish the message */
+    if (__atomic_load_n (&mb->sleeping, __ATOMIC_SEQ_CST) &&                    /* ring only if the receiver sleeps */
+        (futex (&mb->tail, FUTEX_WAKE, 1) == -1))
+        return -1;
+
+    return 0;
+}
+
+/**
+ *  \brief Reception of a message.
+ *
+ *  \param mb pointer to the mailbox
+ *  \param m pointer to the location where the message is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int mbReceive (MAILBOX *mb, MESSAGE *m)
+{
+    unsigned int h = mb->head;                                                   /* only the receiver moves the head */
+
+    while (__atomic_load_n (&mb->tail, __ATOMIC_ACQUIRE) == h) {
+        __atomic_store_n (&mb->sleeping, 1, __ATOMIC_SEQ_CST);
+        if ((__atomic_load_n (&mb->tail, __ATOMIC_SEQ_CST) == h) &&      /* a sender that missed the flag published */
+            (futex (&mb->tail, FUTEX_WAIT, h) == -1) && (errno != EAGAIN) && (errno != EINTR)) {
+            __atomic_store_n (&mb->sleeping, 0, __ATOMIC_RELAXED);
+            return -1;
+        }
+        __atomic_store_n (&mb->sleeping, 0, __ATOMIC_RELAXED);
+    }
+    *m = mb->msg[h % MBOXSIZE];
+    __atomic_store_n (&mb->head, h + 1, __ATOMIC_RELEASE);                              /* free the slot for reuse */
+
+    return 0;
+}
+
+/**
+ *  \brief Reception of a message of a given type.
+ *
+ *  \param mb pointer to the mailbox
+ *  \param type expected message type
+ *  \param arg pointer to the location where the argument of the message is stored (\c NULL if not needed)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>; <tt>EPROTO</tt> if a
+ *     message of another type is received)
+ */
+
+int mbExpect (MAILBOX *mb, unsigned int type, unsigned int *arg)
+{
+    MESSAGE m;
+
+    if (mbReceive (mb, &m) == -1)
+        return -1;
+    if (m.type != type) {
+        errno = EPROTO;
+        return -1;
+    }
+    if (arg != NULL)
+        *arg = m.arg;
+
+    return 0;
+}
+
+/**
+ *  \brief Counting of the messages sent.
+ *
+ *  \param counter pointer to the counter (\c NULL stops counting)
+ */
+
+void mbCount (unsigned long *counter)
+{
+    msgCount = counter;
+}
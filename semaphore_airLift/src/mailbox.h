@@ -0,0 +1,118 @@
+/**
+ *  \file mailbox.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Single-producer/single-consumer mailboxes of small messages.
+ *
+ *  A mailbox is a bounded ring of messages kept in the shared region, with the index of the next message to be sent
+ *  doubling as a futex doorbell: the receiver sleeps on it while the mailbox is empty and the sender only issues a
+ *  wakeup when the receiver is asleep. Only one process may send at a time and only one may receive; several
+ *  processes may take turns as the sender as long as each turn follows the previous one (e.g. it is started by a
+ *  message the previous sender sent).
+ *
+ *  Defined operations:
+ *     \li initialization of a mailbox
+ *     \li sending of a message
+ *     \li reception of a message
+ *     \li reception of a message of a given type
+ *     \li counting of the messages sent.
+ */
+
+#ifndef MAILBOX_H_
+#define MAILBOX_H_
+
+#include "probConst.h"
+
+/**
+ *  \brief Definition of <em>message</em> data type.
+ */
+typedef struct
+{ /** \brief message type */
+    unsigned int type;
+    /** \brief argument of the message */
+    unsigned int arg;
+} MESSAGE;
+
+/**
+ *  \brief Definition of <em>mailbox</em> data type.
+ */
+typedef struct
+{ /** \brief messages of the ring */
+    MESSAGE msg[MBOXSIZE];
+    /** \brief next message to be received */
+    unsigned int head;
+    /** \brief next message to be sent, also the futex word the receiver sleeps on */
+    unsigned int tail;
+    /** \brief the receiver is asleep, or about to sleep, on the doorbell */
+    unsigned int sleeping;
+} MAILBOX;
+
+/**
+ *  \brief Initialization of a mailbox.
+ *
+ *  Must take place before any process uses the mailbox.
+ *
+ *  \param mb pointer to the mailbox
+ */
+
+extern void mbInit (MAILBOX *mb);
+
+/**
+ *  \brief Sending of a message.
+ *
+ *  The receiver is woken up if it is waiting for a message.
+ *
+ *  \param mb pointer to the mailbox
+ *  \param type message type
+ *  \param arg argument of the message
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>; <tt>EAGAIN</tt> if the
+ *     mailbox is full)
+ */
+
+extern int mbSend (MAILBOX *mb, unsigned int type, unsigned int arg);
+
+/**
+ *  \brief Reception of a message.
+ *
+ *  The process blocks until there is a message in the mailbox.
+ *
+ *  \param mb pointer to the mailbox
+ *  \param m pointer to the location where the message is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int mbReceive (MAILBOX *mb, MESSAGE *m);
+
+/**
+ *  \brief Reception of a message of a given type.
+ *
+ *  The process blocks until there is a message in the mailbox, which must be of the given type.
+ *
+ *  \param mb pointer to the mailbox
+ *  \param type expected message type
+ *  \param arg pointer to the location where the argument of the message is stored (\c NULL if not needed)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>; <tt>EPROTO</tt> if a
+ *     message of another type is received)
+ */
+
+extern int mbExpect (MAILBOX *mb, unsigned int type, unsigned int *arg);
+
+/**
+ *  \brief Counting of the messages sent.
+ *
+ *  From now on, every message sent by the calling process increments <tt>*counter</tt> atomically. The counter may
+ *  live in a shared memory region, so it is shared by several processes.
+ *
+ *  \param counter pointer to the counter (\c NULL stops counting)
+ */
+
+extern void mbCount (unsigned long *counter);
+
+#endif /* MAILBOX_H_ */
@@ -0,0 +1,127 @@
+/**
+ *  \file minHeap.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Binary min-heap of timed events.
+ *
+ *  Used by the launcher to schedule the arrival of the passengers at the airport.
+ *
+ *  Defined operations:
+ *     \li heap initialization
+ *     \li insertion of an event
+ *     \li removal of the earliest event
+ *     \li heap destruction.
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+
+#include "minHeap.h"
+
+static void swap (HEAP_ITEM *a, HEAP_ITEM *b)
+{
+    HEAP_ITEM t = *a;
+
+    *a = *b;
+    *b = t;
+}
+
+/**
+ *  \brief Heap initialization.
+ *
+ *  \param h pointer to the heap
+ *  \param cap maximum number of events
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int heapInit (MIN_HEAP *h, unsigned int cap)
+{
+    if ((h->item = malloc (cap * sizeof (HEAP_ITEM))) == NULL)
+        return -1;
+    h->size = 0;
+    h->cap = cap;
+    return 0;
+}
+
+/**
+ *  \brief Insertion of an event.
+ *
+ *  \param h pointer to the heap
+ *  \param time event time
+ *  \param id entity identification
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the heap is full
+ */
+
+int heapPush (MIN_HEAP *h, unsigned long time, unsigned int id)
+{
+    unsigned int i, parent;
+
+    if (h->size == h->cap) {
+        errno = ENOSPC;
+        return -1;
+    }
+    i = h->size++;
+    h->item[i].time = time;
+    h->item[i].id = id;
+    while (i > 0) {                                                                         /* sift the new event up */
+        parent = (i - 1) / 2;
+        if (h->item[parent].time <= h->item[i].time)
+            break;
+        swap (&h->item[parent], &h->item[i]);
+        i = parent;
+    }
+    return 0;
+}
+
+/**
+ *  \brief Removal of the earliest event.
+ *
+ *  \param h pointer to the heap
+ *  \param it pointer to the location where the removed event is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the heap is empty
+ */
+
+int heapPop (MIN_HEAP *h, HEAP_ITEM *it)
+{
+    unsigned int i, l, r, min;
+
+    if (h->size == 0)
+        return -1;
+    *it = h->item[0];
+    h->item[0] = h->item[--h->size];
+    i = 0;
+    for (;;) {                                                                      /* sift the moved event down */
+        l = 2 * i + 1;
+        r = l + 1;
+        min = i;
+        if ((l < h->size) && (h->item[l].time < h->item[min].time))
+            min = l;
+        if ((r < h->size) && (h->item[r].time < h->item[min].time))
+            min = r;
+        if (min == i)
+            break;
+        swap (&h->item[min], &h->item[i]);
+        i = min;
+    }
+    return 0;
+}
+
+/**
+ *  \brief Heap destruction.
+ *
+ *  \param h pointer to the heap
+ */
+
+void heapFree (MIN_HEAP *h)
+{
+    free (h->item);
+    h->item = NULL;
+    h->size = h->cap = 0;
+}
@@ -0,0 +1,89 @@
+/**
+ *  \file minHeap.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Binary min-heap of timed events.
+ *
+ *  Used by the launcher to schedule the arrival of the passengers at the airport.
+ *
+ *  Defined operations:
+ *     \li heap initialization
+ *     \li insertion of an event
+ *     \li removal of the earliest event
+ *     \li heap destruction.
+ */
+
+#ifndef MINHEAP_H_
+#define MINHEAP_H_
+
+/**
+ *  \brief Definition of <em>timed event</em> data type.
+ */
+typedef struct
+{ /** \brief event time (ordering key) */
+    unsigned long time;
+    /** \brief identification of the entity the event refers to */
+    unsigned int id;
+
+} HEAP_ITEM;
+
+/**
+ *  \brief Definition of <em>min-heap</em> data type.
+ */
+typedef struct
+{ /** \brief storage for the events */
+    HEAP_ITEM *item;
+    /** \brief number of events currently stored */
+    unsigned int size;
+    /** \brief maximum number of events */
+    unsigned int cap;
+
+} MIN_HEAP;
+
+/**
+ *  \brief Heap initialization.
+ *
+ *  \param h pointer to the heap
+ *  \param cap maximum number of events
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int heapInit (MIN_HEAP *h, unsigned int cap);
+
+/**
+ *  \brief Insertion of an event.
+ *
+ *  \param h pointer to the heap
+ *  \param time event time
+ *  \param id entity identification
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the heap is full
+ */
+
+extern int heapPush (MIN_HEAP *h, unsigned long time, unsigned int id);
+
+/**
+ *  \brief Removal of the earliest event.
+ *
+ *  \param h pointer to the heap
+ *  \param it pointer to the location where the removed event is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the heap is empty
+ */
+
+extern int heapPop (MIN_HEAP *h, HEAP_ITEM *it);
+
+/**
+ *  \brief Heap destruction.
+ *
+ *  \param h pointer to the heap
+ */
+
+extern void heapFree (MIN_HEAP *h);
+
+#endif /* MINHEAP_H_ */
@@ -0,0 +1,100 @@
+/**
+ *  \file mpscRing.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Bounded lock-free multi-producer/single-consumer ring of passenger ids.
+ *
+ *  Every slot carries a sequence number telling whether it is free for the producer of a given position or holds
+ *  the id for the consumer of that position. Producers claim a position with a compare-and-swap on the tail and then
+ *  publish the id by advancing the sequence number of its slot; the single consumer takes the ids in order of
+ *  position, so the ring is FIFO. No lock is taken, so the ring may be kept in the shared region and used by
+ *  several processes; only the consumer must be unique (or serialized by the caller).
+ *
+ *  Defined operations:
+ *     \li initialization of a ring
+ *     \li insertion of an id (any producer)
+ *     \li retrieval of an id (the consumer).
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+
+#include "probConst.h"
+#include "mpscRing.h"
+
+/**
+ *  \brief Initialization of a ring.
+ *
+ *  \param r pointer to the ring
+ */
+
+void mpscInit (MPSC_RING *r)
+{
+    unsigned int s;
+
+    for (s = 0; s < N; s++)
+        r->slot[s].seq = s;                                               /* each slot is free for its first lap */
+    r->tail = r->head = 0;
+}
+
+/**
+ *  \brief Insertion of an id (any producer).
+ *
+ *  \param r pointer to the ring
+ *  \param id passenger id
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the ring is full (the error is reported on <tt>errno</tt> as <tt>EAGAIN</tt>)
+ */
+
+int mpscPush (MPSC_RING *r, unsigned int id)
+{
+    MPSC_SLOT *s;                                                                             /* slot of the position */
+    unsigned long pos, seq;                                                    /* position, sequence number of slot */
+
+    pos = __atomic_load_n (&r->tail, __ATOMIC_RELAXED);
+    for (;;) {
+        s = &r->slot[pos % N];
+        seq = __atomic_load_n (&s->seq, __ATOMIC_ACQUIRE);
+        if (seq == pos) {                                                            /* free: claim the position */
+            if (__atomic_compare_exchange_n (&r->tail, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;                                                   /* otherwise pos is reloaded by the CAS */
+        }
+        else if ((long) (seq - pos) < 0) {                                 /* not consumed since the previous lap */
+            errno = EAGAIN;
+            return -1;
+        }
+        else pos = __atomic_load_n (&r->tail, __ATOMIC_RELAXED);                    /* claimed by another producer */
+    }
+    s->id = id;
+    __atomic_store_n (&s->seq, pos + 1, __ATOMIC_RELEASE);                                          /* publish the id */
+
+    return 0;
+}
+
+/**
+ *  \brief Retrieval of an id (the consumer).
+ *
+ *  \param r pointer to the ring
+ *  \param id pointer to the location where the id is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the id at the head is not published yet (the error is reported on <tt>errno</tt> as
+ *     <tt>EAGAIN</tt>)
+ */
+
+int mpscPop (MPSC_RING *r, unsigned int *id)
+{
+    MPSC_SLOT *s = &r->slot[r->head % N];                                                         /* slot of the head */
+
+    if (__atomic_load_n (&s->seq, __ATOMIC_ACQUIRE) != r->head + 1) {
+        errno = EAGAIN;
+        return -1;
+    }
+    *id = s->id;
+    __atomic_store_n (&s->seq, r->head + N, __ATOMIC_RELEASE);                    /* free for the next lap's producer */
+    r->head++;
+
+    return 0;
+}
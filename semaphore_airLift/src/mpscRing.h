@@ -0,0 +1,86 @@
+/**
+ *  \file mpscRing.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Bounded lock-free multi-producer/single-consumer ring of passenger ids.
+ *
+ *  Every slot carries a sequence number telling whether it is free for the producer of a given position or holds
+ *  the id for the consumer of that position. Producers claim a position with a compare-and-swap on the tail and then
+ *  publish the id by advancing the sequence number of its slot; the single consumer takes the ids in order of
+ *  position, so the ring is FIFO. No lock is taken, so the ring may be kept in the shared region and used by
+ *  several processes; only the consumer must be unique (or serialized by the caller).
+ *
+ *  Defined operations:
+ *     \li initialization of a ring
+ *     \li insertion of an id (any producer)
+ *     \li retrieval of an id (the consumer).
+ */
+
+#ifndef MPSCRING_H_
+#define MPSCRING_H_
+
+#include "probConst.h"
+
+/**
+ *  \brief Definition of <em>ring slot</em> data type.
+ */
+typedef struct
+{ /** \brief sequence number: position the slot is free for, or that position plus one once the id is published */
+    unsigned long seq;
+    /** \brief passenger id */
+    unsigned int id;
+} MPSC_SLOT;
+
+/**
+ *  \brief Definition of <em>lock-free ring</em> data type.
+ *
+ *  It holds up to N ids, so it never fills up with one id per passenger.
+ */
+typedef struct
+{ /** \brief slots of the ring */
+    MPSC_SLOT slot[N];
+    /** \brief next position to be claimed by a producer */
+    unsigned long tail;
+    /** \brief next position to be taken by the consumer */
+    unsigned long head;
+} MPSC_RING;
+
+/**
+ *  \brief Initialization of a ring.
+ *
+ *  Must take place before any producer or consumer uses the ring.
+ *
+ *  \param r pointer to the ring
+ */
+
+extern void mpscInit (MPSC_RING *r);
+
+/**
+ *  \brief Insertion of an id (any producer).
+ *
+ *  \param r pointer to the ring
+ *  \param id passenger id
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the ring is full (the error is reported on <tt>errno</tt> as <tt>EAGAIN</tt>)
+ */
+
+extern int mpscPush (MPSC_RING *r, unsigned int id);
+
+/**
+ *  \brief Retrieval of an id (the consumer).
+ *
+ *  An id is only taken once its producer has published it, even if producers of later positions already did.
+ *
+ *  \param r pointer to the ring
+ *  \param id pointer to the location where the id is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the id at the head is not published yet (the error is reported on <tt>errno</tt> as
+ *     <tt>EAGAIN</tt>)
+ */
+
+extern int mpscPop (MPSC_RING *r, unsigned int *id);
+
+#endif /* MPSCRING_H_ */
@@ -0,0 +1,84 @@
+/**
+ *  \file prng.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Per-entity pseudo-random number generation.
+ *
+ *  Every entity owns a small generator state (splitmix64) whose seed is derived from the master seed of the run,
+ *  the entity role and its id. Two runs with the same master seed draw the same values.
+ *
+ *  Defined operations:
+ *     \li derivation of an entity seed
+ *     \li generator initialization
+ *     \li generation of a 64-bit value
+ *     \li generation of a uniform value in [0, 1).
+ */
+
+#include <stdint.h>
+
+#include "prng.h"
+
+/** \brief splitmix64 increment */
+#define  GOLDEN     0x9e3779b97f4a7c15ULL
+
+static uint64_t mix (uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ *  \brief Derivation of an entity seed.
+ *
+ *  \param master master seed of the run
+ *  \param role seed stream of the entity
+ *  \param id entity id
+ *
+ *  \return entity seed
+ */
+
+uint64_t prngSeed (uint64_t master, unsigned int role, unsigned int id)
+{
+    return mix (mix (master + GOLDEN * (role + 1)) + GOLDEN * ((uint64_t) id + 1));
+}
+
+/**
+ *  \brief Generator initialization.
+ *
+ *  \param g pointer to the generator state
+ *  \param seed seed
+ */
+
+void prngInit (PRNG *g, uint64_t seed)
+{
+    g->s = seed;
+}
+
+/**
+ *  \brief Generation of a 64-bit value.
+ *
+ *  \param g pointer to the generator state
+ *
+ *  \return next value of the sequence
+ */
+
+uint64_t prngNext (PRNG *g)
+{
+    g->s += GOLDEN;
+    return mix (g->s);
+}
+
+/**
+ *  \brief Generation of a uniform value in [0, 1).
+ *
+ *  \param g pointer to the generator state
+ *
+ *  \return next value of the sequence, scaled to [0, 1)
+ */
+
+double prngUniform (PRNG *g)
+{
+    return (prngNext (g) >> 11) * (1.0 / 9007199254740992.0);
+}
@@ -0,0 +1,82 @@
+/**
+ *  \file prng.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Per-entity pseudo-random number generation.
+ *
+ *  Every entity owns a small generator state (splitmix64) whose seed is derived from the master seed of the run,
+ *  the entity role and its id. Two runs with the same master seed draw the same values.
+ *
+ *  Defined operations:
+ *     \li derivation of an entity seed
+ *     \li generator initialization
+ *     \li generation of a 64-bit value
+ *     \li generation of a uniform value in [0, 1).
+ */
+
+#ifndef PRNG_H_
+#define PRNG_H_
+
+#include <stdint.h>
+
+/* Seed streams */
+
+/** \brief pilot stream */
+#define  SEED_PILOT                   0
+/** \brief passenger stream */
+#define  SEED_PASSENGER               2
+/** \brief launcher stream */
+#define  SEED_LAUNCHER                3
+
+/**
+ *  \brief Definition of <em>generator state</em> data type.
+ */
+typedef struct
+{ /** \brief internal state */
+    uint64_t s;
+
+} PRNG;
+
+/**
+ *  \brief Derivation of an entity seed.
+ *
+ *  \param master master seed of the run
+ *  \param role seed stream of the entity
+ *  \param id entity id
+ *
+ *  \return entity seed
+ */
+
+extern uint64_t prngSeed (uint64_t master, unsigned int role, unsigned int id);
+
+/**
+ *  \brief Generator initialization.
+ *
+ *  \param g pointer to the generator state
+ *  \param seed seed
+ */
+
+extern void prngInit (PRNG *g, uint64_t seed);
+
+/**
+ *  \brief Generation of a 64-bit value.
+ *
+ *  \param g pointer to the generator state
+ *
+ *  \return next value of the sequence
+ */
+
+extern uint64_t prngNext (PRNG *g);
+
+/**
+ *  \brief Generation of a uniform value in [0, 1).
+ *
+ *  \param g pointer to the generator state
+ *
+ *  \return next value of the sequence, scaled to [0, 1)
+ */
+
+extern double prngUniform (PRNG *g);
+
+#endif /* PRNG_H_ */
@@ -13,17 +13,43 @@
 
 /* Generic parameters */
 
-/** \brief number of passengers */
+/** \brief number of passengers (may be overridden at build time, e.g. <tt>make NPASS=1000</tt>) */
+#ifndef N
 #define  N        21 
+#endif
 
-/** \brief min flight capacity */
+/** \brief min flight capacity (may be overridden at build time, e.g. <tt>make MINCAP=8</tt>) */
+#ifndef MINFC
 #define  MINFC     5 
+#endif
 
-/** \brief max flight capacity */
+/** \brief max flight capacity (may be overridden at build time, e.g. <tt>make MAXCAP=16</tt>) */
+#ifndef MAXFC
 #define  MAXFC    10
+#endif
 
-/** \brief max flight capacity */
-#define  MAXNF    10
+/* A build specialized on other values is rejected here rather than at run time */
+
+#if (N < 1) || (MINFC < 1) || (MINFC > MAXFC)
+#error "the number of passengers and the flight capacities must satisfy N >= 1 and 1 <= MINFC <= MAXFC"
+#endif
+
+#if MAXFC > 64
+#error "MAXFC may not exceed 64, the number of semaphores released by a single operation"
+#endif
+
+/** \brief max number of hostesses */
+#define  MAXHT      8
+
+/** \brief max number of planes (one pilot each) */
+#define  MAXPL      8
+
+/** \brief max number of destination airports */
+#define  MAXDEST    4
+
+/** \brief max number of flights of a run, since every flight takes at least one passenger (the departure policy
+           may let a flight leave below MINFC); service mode keeps the last MAXNF flights */
+#define  MAXNF    N
 
 /** \brief max flight capacity */
 #define  MAXTRAVEL   30000.0 
@@ -31,6 +57,106 @@
 /** \brief max flight capacity */
 #define  MAXFLIGHT   2000.0 
 
+/* Arrival process constants */
+
+/** \brief independent uniform travel times */
+#define  ARR_UNIFORM                  0
+/** \brief Poisson arrivals */
+#define  ARR_POISSON                  1
+/** \brief arrivals at a constant rate */
+#define  ARR_CONSTANT                 2
+/** \brief bursty (on/off) Poisson arrivals */
+#define  ARR_ONOFF                    3
+/** \brief arrivals replayed from a trace file */
+#define  ARR_TRACE                    4
+
+/** \brief max length of the name of a trace file */
+#define  MAXPATH                    256
+
+/* Departure policy constants */
+
+/** \brief depart at MAXFC, or at MINFC with nobody in queue */
+#define  DEP_MINFC                    0
+/** \brief as DEP_MINFC, but depart with the passengers on board after a max hold time */
+#define  DEP_HOLD                     1
+/** \brief depart once a target utilisation is reached with nobody in queue */
+#define  DEP_TARGET                   2
+
+/** \brief number of bins of a latency histogram */
+#define  HISTBINS                   640
+
+/* Routing policy constants */
+
+/** \brief fly to the destination with the longest queue */
+#define  ROUTE_LONGEST                0
+/** \brief fly to the destinations in turn */
+#define  ROUTE_CYCLIC                 1
+
+/** \brief increase of the flight duration per destination (destination d is 1 + d * ROUTE_STRETCH times as far
+           as the first one) */
+#define  ROUTE_STRETCH              0.5
+
+/* Priority class constants */
+
+/** \brief number of priority classes of the passengers */
+#define  NCLASS                       3
+/** \brief crew travelling as passengers, boarded first */
+#define  CLASS_CREW                   0
+/** \brief passengers with a connecting flight */
+#define  CLASS_CONNECTION             1
+/** \brief every other passenger */
+#define  CLASS_GENERAL                2
+
+/** \brief default max number of passengers of higher classes boarded ahead of a waiting passenger */
+#define  STARVATION        (2 * MAXFC)
+
+/* Mailbox constants */
+
+/** \brief number of messages a mailbox holds */
+#define  MBOXSIZE                     4
+/** \brief pilot to hostess: the plane at the gate is ready for boarding (argument: flight) */
+#define  MSG_BOARDING_OPEN            0
+/** \brief hostess to passenger: the passport check is complete (argument: plane) */
+#define  MSG_CHECK_DONE               1
+/** \brief hostess to pilot: boarding is complete (argument: passengers on board) */
+#define  MSG_BOARDING_DONE            2
+/** \brief pilot to passenger: the flight arrived, leave the plane (argument: plane) */
+#define  MSG_DISEMBARK                3
+/** \brief last passenger to leave to pilot: the plane is empty (argument: plane) */
+#define  MSG_PLANE_EMPTY              4
+
+/* Life cycle event constants (table-driven entities) */
+
+/** \brief the operation is complete */
+#define  EV_DONE                      0
+/** \brief the air lift is finished */
+#define  EV_FINISHED                  1
+/** \brief the last passenger of the flight boarded */
+#define  EV_LAST                      2
+/** \brief the flight goes on boarding */
+#define  EV_MORE                      3
+/** \brief the hold time of the flight expired */
+#define  EV_TIMEOUT                   4
+
+/* Critical region profile constants */
+
+/** \brief max number of call sites of the critical region profiled */
+#define  MAXCRSITES                  64
+/** \brief max length of the label of a call site (terminator included) */
+#define  CRLABEL                     40
+
+/* Scheduling policy constants */
+
+/** \brief default scheduling class */
+#define  PRIO_NONE                    0
+/** \brief raised nice value */
+#define  PRIO_NICE                    1
+/** \brief real-time FIFO scheduling class */
+#define  PRIO_FIFO                    2
+
+/** \brief max length of a processor list */
+#define  MAXCPULIST                  64
+
 /* Pilot state constants */
 
 /** \brief pilot flying to starting airport */
@@ -14,6 +14,7 @@
 #define PROBDATASTRUCT_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "probConst.h"
 
@@ -22,30 +23,188 @@
  *  \brief Definition of <em>state of the intervening entities</em> data type.
  */
 typedef struct
-{ /** \brief pilot state */
-    unsigned int pilotStat;
-    /** \brief hostess state */
-    unsigned int hostessStat;
+{ /** \brief pilots state array, one per plane (only the first one is used unless there are several planes) */
+    unsigned int pilotStat[MAXPL];
+    /** \brief hostesses state array (only the first one is used unless there are several hostesses) */
+    unsigned int hostessStat[MAXHT];
     /** \brief passengers state array */
     unsigned int passengerStat[N];
 
 } STAT;
 
 
+/**
+ *  \brief Definition of <em>state of a plane</em> data type.
+ */
+typedef struct
+{ /** \brief number of the present (or last) flight of the plane */
+    unsigned int flight;
+    /** \brief number of passengers on board */
+    unsigned int nPass;
+    /** \brief number of flights made */
+    unsigned int nFlights;
+    /** \brief number of passengers carried */
+    unsigned int nCarried;
+    /** \brief destination of the present (or last) flight of the plane */
+    unsigned int dest;
+} PLANE_STAT;
+
+/**
+ *  \brief Definition of <em>state of a route</em> data type (from the origin to one destination).
+ */
+typedef struct
+{ /** \brief number of passengers flying to the destination */
+    unsigned int nPass;
+    /** \brief number of flights to the destination */
+    unsigned int nFlights;
+    /** \brief number of passengers already boarded to the destination (every trip in service mode) */
+    unsigned int nBoarded;
+} ROUTE_STAT;
+
+/**
+ *  \brief Definition of <em>arrival process</em> data type.
+ */
+typedef struct
+{ /** \brief kind of process (ARR_UNIFORM, ARR_POISSON, ARR_CONSTANT, ARR_ONOFF or ARR_TRACE) */
+    unsigned int kind;
+    /** \brief arrival rate (passengers per second) */
+    double rate;
+    /** \brief duration of a burst (s), on/off process */
+    double on;
+    /** \brief duration of a pause between bursts (s), on/off process */
+    double off;
+    /** \brief name of the trace file, trace process */
+    char trace[MAXPATH];
+
+} ARRIVAL_PROC;
+
+
+/**
+ *  \brief Definition of <em>departure policy</em> data type.
+ */
+typedef struct
+{ /** \brief kind of policy (DEP_MINFC, DEP_HOLD or DEP_TARGET) */
+    unsigned int kind;
+    /** \brief max hold time of a boarding plane (s), hold policy */
+    double hold;
+    /** \brief target utilisation of a flight, in (0, 1], target policy */
+    double target;
+} DEPARTURE_POLICY;
+
+/**
+ *  \brief Definition of <em>priority classes</em> data type.
+ *
+ *  Higher classes are boarded first, but a passenger in queue is never overtaken by more than <tt>bound</tt>
+ *  passengers of higher classes.
+ */
+typedef struct
+{ /** \brief share of the passengers in each class (crew, connection and general) */
+    double share[NCLASS];
+    /** \brief max number of passengers of higher classes boarded ahead of a waiting passenger, 0 if passengers are
+               not classified (all general) */
+    unsigned int bound;
+} CLASS_POLICY;
+
+/**
+ *  \brief Definition of <em>scheduling policy</em> data type.
+ *
+ *  Arrays are indexed by role: pilot, hostess and passengers.
+ */
+typedef struct
+{ /** \brief processors each role may run on (processor list such as 0-3,6), empty if unrestricted */
+    char cpus[3][MAXCPULIST];
+    /** \brief scheduling class requested for the pilot and the hostess (PRIO_NONE, PRIO_NICE or PRIO_FIFO) */
+    unsigned int prio;
+    /** \brief scheduling class actually applied to the pilot and the hostess */
+    unsigned int applied[2];
+
+} SCHED_POLICY;
+
+
+/**
+ *  \brief Definition of <em>simulation parameters</em> data type.
+ *
+ *  They are set by the launcher before the start of operations and are read-only afterwards.
+ */
+typedef struct
+{ /** \brief master seed from which every entity derives its own seed */
+    uint64_t seed;
+    /** \brief process generating the arrivals of the passengers at the airport */
+    ARRIVAL_PROC arrivals;
+    /** \brief passengers are spawned by the launcher upon arrival at the airport */
+    bool jitSpawn;
+    /** \brief continuous service mode: passengers travel back to the airport after reaching the destination */
+    bool service;
+    /** \brief duration of a service mode run (s), 0 if unbounded */
+    double duration;
+    /** \brief number of flights of a service mode run, 0 if unbounded */
+    unsigned int maxFlights;
+    /** \brief time without progress after which the watchdog aborts the run (s), 0 if there is no watchdog */
+    double stall;
+    /** \brief reduced-handshake boarding protocol: the passenger leaves its id in the queue and the hostess wakes it
+               up once the check is over */
+    bool fastBoarding;
+    /** \brief the passengers publish their ids in a lock-free ring, outside the critical region (reduced-handshake
+               protocol) */
+    bool lockFree;
+    /** \brief the entities wait on event file descriptors created by the launcher instead of the semaphore set */
+    bool eventFd;
+    /** \brief the pilot, the hostess and the passengers exchange messages through mailboxes instead of signaling
+               semaphores (reduced-handshake protocol) */
+    bool mailbox;
+    /** \brief the time waited for and held in the critical regions is recorded per call site */
+    bool lockStats;
+    /** \brief pipelined boarding: while the plane is away, the hostess pre-checks the passports of the passengers in
+               queue, who board as soon as the next flight opens */
+    bool preBoarding;
+    /** \brief max size of a party of passengers flying together, 0 or 1 if passengers travel alone */
+    unsigned int maxGroup;
+    /** \brief priority classes of the passengers in queue */
+    CLASS_POLICY classes;
+    /** \brief rule deciding when a boarding flight departs */
+    DEPARTURE_POLICY departure;
+    /** \brief max number of passengers checked by the hostess at once (batch mode if greater than 1) */
+    unsigned int batch;
+    /** \brief number of hostesses boarding the flight in parallel */
+    unsigned int nHostess;
+    /** \brief number of planes in the fleet, each one with its own pilot */
+    unsigned int nPlanes;
+    /** \brief number of destination airports */
+    unsigned int nDest;
+    /** \brief rule choosing the destination of the next flight (ROUTE_LONGEST or ROUTE_CYCLIC) */
+    unsigned int routing;
+    /** \brief processor affinity and scheduling class of the intervening entities */
+    SCHED_POLICY sched;
+
+} PARAM;
+
+
 /**
  *  \brief Definition of <em>full state of the problem</em> data type.
  */
 typedef struct
-{ /** \brief state of all intervening entities */
+{ /** \brief simulation parameters */
+    PARAM par;
+    /** \brief state of all intervening entities */
     STAT st;
-    /** \brief number of passengers at each flight */
+    /** \brief number of passengers at each flight (the last MAXNF flights in service mode) */
     unsigned int nPassengersInFlight[MAXNF];
+    /** \brief plane of each flight (the last MAXNF flights in service mode) */
+    unsigned int flightPlane[MAXNF];
+    /** \brief destination of each flight (the last MAXNF flights in service mode) */
+    unsigned int flightDest[MAXNF];
     /** \brief flight number */
     unsigned int nFlight;
+    /** \brief state of each plane */
+    PLANE_STAT plane[MAXPL];
+    /** \brief plane at the boarding gate */
+    unsigned int atGate;
+    /** \brief state of the route to each destination */
+    ROUTE_STAT route[MAXDEST];
 
     /** \brief number of passengers waiting */
     unsigned int nPassInQueue;
-    /** \brief number of passengers flying */
+    /** \brief number of passengers flying (on board of any plane) */
     unsigned int nPassInFlight;
     /** \brief total number of passengers already boarded in every flight */
     unsigned int totalPassBoarded;
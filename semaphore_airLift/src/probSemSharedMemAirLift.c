@@ -11,6 +11,95 @@
  *  Upon execution, one parameter is requested:
  *    \li name of the logging file.
  *
+ *  Leftover semaphore set and shared memory region of a crashed run (same access key, creator no longer alive) are
+ *  removed at startup. Upon <tt>SIGINT</tt> or <tt>SIGTERM</tt> the intervening entities are terminated and both
+ *  are removed before exiting.
+ *
+ *  Options:
+ *    \li <tt>-a</tt> <em>spec</em>, <tt>--arrivals</tt>=<em>spec</em>: open-loop arrival process of the passengers at
+ *        the airport: <tt>uniform</tt> (default), <tt>poisson:</tt><em>rate</em>, <tt>constant:</tt><em>rate</em> or
+ *        <tt>onoff:</tt><em>rate</em><tt>:</tt><em>on</em><tt>:</tt><em>off</em> (rates in passengers per second,
+ *        durations in seconds), or <tt>trace:</tt><em>file</em> to replay the arrival times of a trace file (CSV with
+ *        times in seconds, or <tt>.bin</tt> with 64-bit times in us). The offered load is reported next to the
+ *        achieved throughput.
+ *    \li <tt>-b</tt> <em>k</em>, <tt>--batch</tt>=<em>k</em>: the hostess checks up to <em>k</em> queued passengers (at most
+ *        MAXFC) in a single critical region and releases them together; implies <tt>-F</tt>.
+ *    \li <tt>-C</tt> <em>role</em><tt>:</tt><em>cpus</em>, <tt>--cpus</tt>=<em>role</em><tt>:</tt><em>cpus</em>: restrict
+ *        <tt>pilot</tt>, <tt>hostess</tt> or <tt>passengers</tt> to a processor list (<tt>0-3,6</tt>); may be repeated.
+ *    \li <tt>-c</tt>, <tt>--clean</tt>: only remove leftover semaphore set and shared memory region, and exit.
+ *    \li <tt>-D</tt> <em>policy</em>, <tt>--departure</tt>=<em>policy</em>: rule deciding when a boarding flight
+ *        departs: <tt>minfc</tt> (default, at MAXFC passengers or at MINFC with nobody in queue),
+ *        <tt>hold:</tt><em>secs</em> (as <tt>minfc</tt>, but after <em>secs</em> of boarding the flight departs with
+ *        the passengers on board if nobody is in queue; requires a single hostess) or <tt>target:</tt><em>u</em>
+ *        (with nobody in queue once a fraction <em>u</em> of the seats is taken). The mean and p99 passenger wait,
+ *        from joining the queue to the departure of the flight, are written at the end of the log.
+ *    \li <tt>-E</tt>, <tt>--eventfd</tt>: the entities wait on event file descriptors (<tt>eventfd</tt> in semaphore
+ *        mode, one per semaphore) created by the launcher and inherited by every process, instead of the semaphore
+ *        set; only the start of operations is still signalled on the semaphore set. <tt>semBench</tt> compares the
+ *        wakeup latency of both backends.
+ *    \li <tt>-F</tt>, <tt>--fast</tt>: reduced-handshake boarding protocol; each passenger leaves its id in a queue in the
+ *        shared region and the hostess completes the check with a single wakeup of that passenger (one semaphore per
+ *        passenger). The number of semaphore operations per boarded passenger is written at the end of the log.
+ *    \li <tt>-j</tt>, <tt>--jit</tt>: the launcher draws the arrival times of the passengers and only spawns each
+ *        passenger when it reaches the airport (just-in-time spawning).
+ *    \li <tt>-S</tt>, <tt>--service</tt>: continuous service mode; passengers that reach the destination travel back
+ *        to the airport and queue again, and the pilot and hostess loop until the run is stopped by
+ *        <tt>-d</tt> or <tt>-f</tt>. The throughput is reported every <tt>-i</tt> seconds.
+ *    \li <tt>-d</tt> <em>secs</em>, <tt>--duration</tt>=<em>secs</em>: duration of a service mode run.
+ *    \li <tt>-f</tt> <em>flights</em>, <tt>--flights</tt>=<em>flights</em>: number of flights of a service mode run.
+ *    \li <tt>-G</tt> <em>k</em>, <tt>--groups</tt>=<em>k</em>: passengers travel in parties of 1 to <em>k</em> (at most
+ *        MAXFC) consecutive ids, drawn from the master seed; the members of a party arrive together, are queued
+ *        together and always fly on the same flight (a party that does not fit in the plane waits for the next one);
+ *        implies <tt>-F</tt> and is not compatible with <tt>-b</tt>, <tt>-H</tt> or <tt>-p</tt>.
+ *    \li <tt>-H</tt> <em>h</em>, <tt>--hostesses</tt>=<em>h</em>: <em>h</em> hostesses (at most MAXHT) board each flight in
+ *        parallel, claiming passengers from a shared queue; implies <tt>-F</tt> and is not compatible with
+ *        <tt>-b</tt>. The log shows one state column per hostess.
+ *    \li <tt>-K</tt> <em>crew</em><tt>:</tt><em>conn</em>[<tt>:</tt><em>bound</em>],
+ *        <tt>--classes</tt>=<em>crew</em><tt>:</tt><em>conn</em>[<tt>:</tt><em>bound</em>]: priority boarding; a share
+ *        <em>crew</em> of the passengers (parties) are crew and a share <em>conn</em> have a connecting flight, drawn
+ *        from the master seed, and the rest are general. The hostess takes passengers from a queue per class, higher
+ *        classes first, but a waiting passenger is never overtaken by more than <em>bound</em> passengers of higher
+ *        classes (default 2 * MAXFC). The queue waiting time percentiles of each class are written at the end of the
+ *        log; implies <tt>-F</tt>.
+ *    \li <tt>-L</tt>, <tt>--lockfree</tt>: the passengers publish their ids in a bounded lock-free
+ *        multi-producer/single-consumer ring in the shared region, without taking the mutex, and the hostess takes
+ *        them in order of arrival; implies <tt>-F</tt> and is not compatible with <tt>-G</tt>, <tt>-H</tt>,
+ *        <tt>-K</tt> or <tt>-T</tt>. <tt>bench.sh</tt> compares it with the other boarding protocols.
+ *    \li <tt>-l</tt>, <tt>--lockstats</tt>: critical region profile; the time each entity waits for the mutex and the
+ *        time it holds it are recorded per call site (e.g. <tt>HT.checkPassport.count</tt>) in histograms in the
+ *        shared region, whose percentiles are written at the end of the log.
+ *    \li <tt>-M</tt>, <tt>--mailbox</tt>: message passing; the pilot, the hostess and each passenger own a
+ *        single-producer/single-consumer mailbox in the shared region, with a futex doorbell, and the opening and end
+ *        of the boarding, the end of each passport check, the arrival of the flight and the empty plane are messages
+ *        instead of semaphore signals (the passengers still join the queue as with <tt>-F</tt>). The number of
+ *        messages per boarded passenger is written at the end of the log; implies <tt>-F</tt> and requires a single
+ *        hostess, without <tt>-b</tt>, <tt>-G</tt> or <tt>-p</tt>.
+ *    \li <tt>-P</tt> <em>p</em>, <tt>--planes</tt>=<em>p</em>: fleet of <em>p</em> planes (at most MAXPL), each one with its
+ *        own pilot; the pilots take turns at the boarding gate and the flights are listed with their plane. The log
+ *        shows one pilot state column per plane.
+ *    \li <tt>-p</tt>, <tt>--preboard</tt>: pipelined boarding; while the plane is away the hostess pre-checks the
+ *        passports of up to MAXFC passengers in queue, who board as soon as the next flight opens (the departure rule
+ *        still applies); implies <tt>-F</tt> and requires a single hostess.
+ *    \li <tt>-T</tt> <em>d</em>[<tt>:</tt><em>policy</em>], <tt>--destinations</tt>=<em>d</em>[<tt>:</tt><em>policy</em>]:
+ *        <em>d</em> destination airports (at most MAXDEST), one drawn uniformly from the master seed for each passenger
+ *        (party), each with its own queue; destination <em>k</em> is 1 + <em>k</em> * ROUTE_STRETCH times as far as the
+ *        first one. The pilot chooses the destination of each flight by the routing policy, <tt>longest</tt> (default,
+ *        longest queue) or <tt>cyclic</tt> (in turn), and the hostess only boards passengers for that destination. The
+ *        flights and throughput of each destination are written at the end of the log; implies <tt>-F</tt> and
+ *        requires a single hostess, without <tt>-p</tt>.
+ *    \li <tt>-i</tt> <em>secs</em>, <tt>--interval</tt>=<em>secs</em>: throughput reporting interval (default 1 s).
+ *    \li <tt>-r</tt> <em>class</em>, <tt>--priority</tt>=<em>class</em>: raise the scheduling priority of the pilot and the
+ *        hostess, <tt>nice</tt> or <tt>fifo</tt> (real-time, falls back to <tt>nice</tt> and then to the default class
+ *        when not permitted). The policy applied is written at the end of the log.
+ *    \li <tt>-s</tt> <em>seed</em>, <tt>--seed</tt>=<em>seed</em>: master seed of the run; every entity derives its
+ *        own seed from it, so runs with the same seed and configuration are reproducible (by default a seed is
+ *        drawn from the clock and the process id, and is written in the log header).
+ *    \li <tt>-W</tt> <em>secs</em>, <tt>--watchdog</tt>=<em>secs</em>: spawn a watchdog that aborts the run (writing a
+ *        diagnostic snapshot to its error file) if the state and the semaphores do not change for <em>secs</em>.
+ *    \li <tt>-w</tt>[<em>W</em>], <tt>--workers</tt>[=<em>W</em>]: the passengers are hosted by <em>W</em> worker processes
+ *        (one per online processor if <em>W</em> is omitted), each running a contiguous range of passenger ids
+ *        as threads.
+ *
  *  \author Nuno Lau - January 2022
  */
 
@@ -19,10 +108,15 @@
 #include <stdbool.h>
 #include <unistd.h>
 #include <sys/wait.h>
+#include <sys/resource.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
+#include <getopt.h>
+#include <errno.h>
+#include <signal.h>
 
 #include "probConst.h"
 #include "probDataStruct.h"
@@ -30,6 +124,15 @@
 #include "sharedDataSync.h"
 #include "semaphore.h"
 #include "sharedMemory.h"
+#include "minHeap.h"
+#include "accounting.h"
+#include "prng.h"
+#include "arrivals.h"
+#include "schedPolicy.h"
+#include "departure.h"
+#include "boardingQueue.h"
+#include "mpscRing.h"
+#include "mailbox.h"
 
 /** \brief name of pilot process */
 #define   PILOT         "./pilot"
@@ -40,6 +143,31 @@
 /** \brief name of passenger process */
 #define   PASSENGER     "./passenger"
 
+/** \brief name of watchdog process */
+#define   WATCHDOG      "./watchdog"
+
+/** \brief shared memory access identifier */
+static int shmid = -1;
+
+/** \brief semaphore set access identifier */
+static int semgid = -1;
+
+/** \brief launcher process identifier */
+static int pidLauncher;
+
+static void removeStaleIpc (int key);
+static void abortRun (int sig);
+static void usage (char *name);
+static int parseCpus (char *spec, SCHED_POLICY *sp);
+static void applyPolicy (SCHED_POLICY *sp, unsigned int role);
+static int spawnPassenger (unsigned int first, unsigned int last, char nFic[], char key[], SCHED_POLICY *sp);
+static void formGroups (SHARED_DATA *sh, unsigned int maxGroup, uint64_t seed);
+static void assignClasses (SHARED_DATA *sh, CLASS_POLICY *cp, uint64_t seed);
+static void assignDestinations (SHARED_DATA *sh, unsigned int nDest, uint64_t seed);
+static unsigned int scheduleArrivals (SHARED_DATA *sh, char nFic[], char key[], int pidPG[]);
+static unsigned int reapChildren (bool block);
+static unsigned int serveUntilStop (SHARED_DATA *sh, char nFic[], double interval, int pidPT[]);
+
 /**
  *  \brief Main program.
  *
@@ -51,22 +179,243 @@ int main (int argc, char *argv[])
 {
     char nFic[51];                                                                              /*name of logging file */
     char nFicErr[] = "error_        ";                                                     /* base name of error files */
-    int shmid,                                                                      /* shared memory access identifier */
-        semgid;                                                                     /* semaphore set access identifier */
     unsigned int  m;                                                                             /* counting variables */
     SHARED_DATA *sh;                                                                /* pointer to shared memory region */
-    int pidPT,                                                                             /* pilot process identifier */
-        pidHT,                                                                     /* hostess process identifier array */
+    int pidPT[MAXPL],                                                                /* pilot process identifier array */
+        pidHT[MAXHT],                                                              /* hostess process identifier array */
+        pidWD = -1,                                                                     /* watchdog process identifier */
         pidPG[N];                                                             /* passengers processes identifier array */
     int key;                                                           /*access key to shared memory and semaphore set */
     char num[2][12];                                                     /* numeric value conversion (up to 10 digits) */
-    int status,                                                                                    /* execution status */
-        info;                                                                                               /* info id */
     int p;
+    unsigned int h, t;
+    unsigned int nPG = N,                                                               /* number of passenger processes */
+                 first;                                                        /* first passenger hosted by a worker */
+    PARAM par;                                                                              /* simulation parameters */
+    double interval = 1.0;                                              /* service mode throughput reporting interval */
+    bool cleanOnly = false;                                                           /* only remove leftover IPC */
+    struct sigaction sa;                                                          /* termination signals disposition */
+    struct timespec now;
+    double makespan;                                                                /* duration of the run (s) */
+    struct rlimit fdLimit;                                                   /* max number of open file descriptors */
+    static struct option longOpt[] = {{"arrivals", required_argument, NULL, 'a'},
+                                      {"batch", required_argument, NULL, 'b'},
+                                      {"clean", no_argument, NULL, 'c'},
+                                      {"cpus", required_argument, NULL, 'C'},
+                                      {"departure", required_argument, NULL, 'D'},
+                                      {"duration", required_argument, NULL, 'd'},
+                                      {"eventfd", no_argument, NULL, 'E'},
+                                      {"fast", no_argument, NULL, 'F'},
+                                      {"flights", required_argument, NULL, 'f'},
+                                      {"groups", required_argument, NULL, 'G'},
+                                      {"hostesses", required_argument, NULL, 'H'},
+                                      {"interval", required_argument, NULL, 'i'},
+                                      {"classes", required_argument, NULL, 'K'},
+                                      {"jit", no_argument, NULL, 'j'},
+                                      {"lockfree", no_argument, NULL, 'L'},
+                                      {"lockstats", no_argument, NULL, 'l'},
+                                      {"mailbox", no_argument, NULL, 'M'},
+                                      {"planes", required_argument, NULL, 'P'},
+                                      {"preboard", no_argument, NULL, 'p'},
+                                      {"priority", required_argument, NULL, 'r'},
+                                      {"service", no_argument, NULL, 'S'},
+                                      {"destinations", required_argument, NULL, 'T'},
+                                      {"seed", required_argument, NULL, 's'},
+                                      {"watchdog", required_argument, NULL, 'W'},
+                                      {"workers", optional_argument, NULL, 'w'},
+                                      {NULL, 0, NULL, 0}};
+    int opt;
+    char *tinp;                                                                      /* numerical parameters test flag */
+
+    memset (&par, 0, sizeof (par));
+    par.nHostess = 1;
+    par.nPlanes = 1;
+    par.nDest = 1;
+    clock_gettime (CLOCK_REALTIME, &now);
+    par.seed = prngSeed ((uint64_t) now.tv_sec * 1000000000 + now.tv_nsec, SEED_LAUNCHER, getpid ());
 
-    /* getting log file name */
-    if(argc==2) {
-        strcpy(nFic, argv[1]);
+    /* getting options and log file name */
+    while ((opt = getopt_long (argc, argv, "a:b:C:cD:d:EFf:G:H:i:jK:lLMP:pr:Ss:T:W:w::", longOpt, NULL)) != -1) {
+        switch (opt) {
+            case 'a': if (arrivalParse (optarg, &par.arrivals) == -1) {
+                          fprintf (stderr, "Arrival process is wrong!\n");
+                          exit (EXIT_FAILURE);
+                      }
+                      break;
+            case 'b': par.batch = (unsigned int) strtol (optarg, &tinp, 0);
+                      if ((*tinp != '\0') || (par.batch == 0)) {
+                          fprintf (stderr, "Batch size is wrong!\n");
+                          exit (EXIT_FAILURE);
+                      }
+                      if (par.batch > MAXFC)
+                          par.batch = MAXFC;
+                      par.fastBoarding = true;
+                      break;
+            case 'C': if (parseCpus (optarg, &par.sched) == -1) {
+                          fprintf (stderr, "Processor list is wrong!\n");
+                          exit (EXIT_FAILURE);
+                      }
+                      break;
+            case 'c': cleanOnly = true;
+                      break;
+            case 'D': if (departureParse (optarg, &par.departure) == -1) {
+                          fprintf (stderr, "Departure policy is wrong!\n");
+                          exit (EXIT_FAILURE);
+                      }
+                      break;
+            case 'd': par.duration = strtod (optarg, &tinp);
+                      if ((*tinp != '\0') || (par.duration <= 0.0)) {
+                          fprintf (stderr, "Service duration is wrong!\n");
+                          exit (EXIT_FAILURE);
+                      }
+                      break;
+            case 'E': par.eventFd = true;
+                      break;
+            case 'F': par.fastBoarding = true;
+                      break;
+            case 'f': par.maxFlights = (unsigned int) strtol (optarg, &tinp, 0);
+                      if ((*tinp != '\0') || (par.maxFlights == 0)) {
+                          fprintf (stderr, "Number of service flights is wrong!\n");
+                          exit (EXIT_FAILURE);
+                      }
+                      break;
+            case 'G': par.maxGroup = (unsigned int) strtol (optarg, &tinp, 0);
+                      if ((*tinp != '\0') || (par.maxGroup == 0) || (par.maxGroup > MAXFC)) {
+                          fprintf (stderr, "Max party size is wrong!\n");
+                          exit (EXIT_FAILURE);
+                      }
+                      if (par.maxGroup > 1)
+                          par.fastBoarding = true;
+                      break;
+            case 'H': par.nHostess = (unsigned int) strtol (optarg, &tinp, 0);
+                      if ((*tinp != '\0') || (par.nHostess == 0) || (par.nHostess > MAXHT)) {
+                          fprintf (stderr, "Number of hostesses is wrong!\n");
+                          exit (EXIT_FAILURE);
+                      }
+                      if (par.nHostess > 1)
+                          par.fastBoarding = true;
+                      break;
+            case 'i': interval = strtod (optarg, &tinp);
+                      if ((*tinp != '\0') || (interval <= 0.0)) {
+                          fprintf (stderr, "Reporting interval is wrong!\n");
+                          exit (EXIT_FAILURE);
+                      }
+                      break;
+            case 'j': par.jitSpawn = true;
+                      break;
+            case 'K': if (bqParse (optarg, &par.classes) == -1) {
+                          fprintf (stderr, "Priority classes are wrong!\n");
+                          exit (EXIT_FAILURE);
+                      }
+                      par.fastBoarding = true;
+                      break;
+            case 'l': par.lockStats = true;
+                      break;
+            case 'L': par.lockFree = true;
+                      par.fastBoarding = true;
+                      break;
+            case 'M': par.mailbox = true;
+                      par.fastBoarding = true;
+                      break;
+            case 'P': par.nPlanes = (unsigned int) strtol (optarg, &tinp, 0);
+                      if ((*tinp != '\0') || (par.nPlanes == 0) || (par.nPlanes > MAXPL)) {
+                          fprintf (stderr, "Number of planes is wrong!\n");
+                          exit (EXIT_FAILURE);
+                      }
+                      break;
+            case 'p': par.preBoarding = true;
+                      par.fastBoarding = true;
+                      break;
+            case 'r': if (strcmp (optarg, "nice") == 0)
+                          par.sched.prio = PRIO_NICE;
+                      else if (strcmp (optarg, "fifo") == 0)
+                          par.sched.prio = PRIO_FIFO;
+                      else {
+                          fprintf (stderr, "Scheduling class is wrong!\n");
+                          exit (EXIT_FAILURE);
+                      }
+                      break;
+            case 'S': par.service = true;
+                      break;
+            case 's': par.seed = strtoull (optarg, &tinp, 0);
+                      if (*tinp != '\0') {
+                          fprintf (stderr, "Master seed is wrong!\n");
+                          exit (EXIT_FAILURE);
+                      }
+                      break;
+            case 'T': par.nDest = (unsigned int) strtol (optarg, &tinp, 0);
+                      if (strcmp (tinp, ":cyclic") == 0)
+                          par.routing = ROUTE_CYCLIC;
+                      else if ((*tinp == '\0') || (strcmp (tinp, ":longest") == 0))
+                          par.routing = ROUTE_LONGEST;
+                      else par.nDest = 0;
+                      if ((par.nDest == 0) || (par.nDest > MAXDEST)) {
+                          fprintf (stderr, "Destinations are wrong!\n");
+                          exit (EXIT_FAILURE);
+                      }
+                      if (par.nDest > 1)
+                          par.fastBoarding = true;
+                      break;
+            case 'W': par.stall = strtod (optarg, &tinp);
+                      if ((*tinp != '\0') || (par.stall < 0.0)) {
+                          fprintf (stderr, "Watchdog stall period is wrong!\n");
+                          exit (EXIT_FAILURE);
+                      }
+                      break;
+            case 'w': if (optarg == NULL)
+                          nPG = (unsigned int) sysconf (_SC_NPROCESSORS_ONLN);
+                      else {
+                          nPG = (unsigned int) strtol (optarg, &tinp, 0);
+                          if ((*tinp != '\0') || (nPG == 0)) {
+                              fprintf (stderr, "Number of passenger workers is wrong!\n");
+                              exit (EXIT_FAILURE);
+                          }
+                      }
+                      if (nPG > N)
+                          nPG = N;
+                      break;
+            default:  usage (argv[0]);
+                      exit (EXIT_FAILURE);
+        }
+    }
+    if (par.service && (par.duration == 0.0) && (par.maxFlights == 0)) {
+        fprintf (stderr, "Service mode requires a duration or a number of flights!\n");
+        exit (EXIT_FAILURE);
+    }
+    if ((par.nHostess > 1) && (par.batch > 1)) {
+        fprintf (stderr, "Batch mode requires a single hostess!\n");
+        exit (EXIT_FAILURE);
+    }
+    if ((par.nHostess > 1) && (par.departure.kind == DEP_HOLD)) {
+        fprintf (stderr, "Departure after a hold time requires a single hostess!\n");
+        exit (EXIT_FAILURE);
+    }
+    if ((par.nHostess > 1) && par.preBoarding) {
+        fprintf (stderr, "Pipelined boarding requires a single hostess!\n");
+        exit (EXIT_FAILURE);
+    }
+    if ((par.maxGroup > 1) && ((par.nHostess > 1) || (par.batch > 1) || par.preBoarding)) {
+        fprintf (stderr, "Parties of passengers require a single hostess, without batch or pipelined boarding!\n");
+        exit (EXIT_FAILURE);
+    }
+    if ((par.nDest > 1) && ((par.nHostess > 1) || par.preBoarding)) {
+        fprintf (stderr, "Several destinations require a single hostess, without pipelined boarding!\n");
+        exit (EXIT_FAILURE);
+    }
+    if (par.lockFree && ((par.nHostess > 1) || (par.maxGroup > 1) || (par.classes.bound > 0) || (par.nDest > 1))) {
+        fprintf (stderr, "The lock-free queue requires a single hostess, without parties, classes or destinations!\n");
+        exit (EXIT_FAILURE);
+    }
+    if (par.mailbox && ((par.nHostess > 1) || (par.batch > 1) || (par.maxGroup > 1) || par.preBoarding)) {
+        fprintf (stderr, "Mailboxes require a single hostess, without batch, parties or pipelined boarding!\n");
+        exit (EXIT_FAILURE);
+    }
+    if (par.jitSpawn && (nPG != N)) {
+        fprintf (stderr, "Just-in-time spawning requires one process per passenger!\n");
+        exit (EXIT_FAILURE);
+    }
+    if(optind == argc-1) {
+        strcpy(nFic, argv[optind]);
     }
     else strcpy(nFic, "");
 
@@ -78,6 +427,22 @@ int main (int argc, char *argv[])
     }
     sprintf (num[1], "%d", key);
 
+    /* removing leftovers of a crashed run and installing cleanup upon termination signals */
+
+    removeStaleIpc (key);
+    if (cleanOnly)
+        exit (EXIT_SUCCESS);
+    pidLauncher = getpid ();
+    memset (&sa, 0, sizeof (sa));
+    sa.sa_handler = abortRun;
+    sigemptyset (&sa.sa_mask);
+    sigaddset (&sa.sa_mask, SIGINT);
+    sigaddset (&sa.sa_mask, SIGTERM);
+    if ((sigaction (SIGINT, &sa, NULL) == -1) || (sigaction (SIGTERM, &sa, NULL) == -1)) {
+        perror ("error on installing the termination signals handler");
+        exit (EXIT_FAILURE);
+    }
+
     /* creating and initializing the shared memory region and the log file */
 
     if ((shmid = shmemCreate (key, sizeof (SHARED_DATA))) == -1) { 
@@ -89,107 +454,214 @@ int main (int argc, char *argv[])
         exit (EXIT_FAILURE);
     }
 
-    srandom ((unsigned int) getpid ());                                                      /* initialize random generator */
-
 
     /* initialize problem internal status */
 
-    sh->fSt.st.pilotStat   = FLYING_BACK;                                   /* the pilot is flying towards starting airport */
-    sh->fSt.st.hostessStat = WAIT_FOR_FLIGHT;                            /* the hostess is waiting for the flight to arrive */
+    for (t = 0; t < MAXPL; t++)
+        sh->fSt.st.pilotStat[t] = FLYING_BACK;                       /* the pilots are flying towards starting airport */
+    for (h = 0; h < MAXHT; h++)
+        sh->fSt.st.hostessStat[h] = WAIT_FOR_FLIGHT;                 /* the hostesses are waiting for the flight to arrive */
     for (p = 0; p < N; p++) {
         sh->fSt.st.passengerStat[p] = GOING_TO_AIRPORT;                          /* the passengers are going to the airport */
     }
     sh->fSt.finished         = false;                                       
+    sh->fSt.par              = par;
+    if (arrivalGenerate (&par.arrivals, par.seed, sh->arrival, N) == -1) {    /* open-loop arrivals of passengers */
+        perror ("error on reading the arrival trace file");
+        shmemDestroy (shmid);
+        exit (EXIT_FAILURE);
+    }
+    formGroups (sh, par.maxGroup, par.seed);                                 /* parties of passengers, if any */
+    assignClasses (sh, &par.classes, par.seed);                          /* priority class of each passenger */
+    assignDestinations (sh, par.nDest, par.seed);                             /* destination of each passenger */
     sh->fSt.nPassInQueue     = 0;                                          
     sh->fSt.nPassInFlight    = 0;                                         
+    memset (sh->fSt.plane, 0, sizeof (sh->fSt.plane));                                    /* the planes are empty */
+    sh->fSt.atGate = 0;
     sh->fSt.totalPassBoarded = 0;                                        
+    for (t = 0; t < MAXDEST; t++)
+        bqInit (&sh->queue[t]);                                                  /* passengers queues are empty */
+    memset (sh->queueWait, 0, sizeof (sh->queueWait));
+    mpscInit (&sh->ring);
+    mbInit (&sh->hostessBox);                                                               /* mailboxes are empty */
+    for (t = 0; t < MAXPL; t++)
+        mbInit (&sh->pilotBox[t]);
+    for (p = 0; p < N; p++)
+        mbInit (&sh->passengerBox[p]);
+    sh->msgOps = 0;
+    memset (&sh->crProf, 0, sizeof (sh->crProf));                                 /* no critical region entered yet */
+    sh->semOps = 0;
+    sh->boarding = false;
+    sh->spare = 0;
+    memset (&sh->wait, 0, sizeof (sh->wait));                                    /* no passenger waited yet */
+    sh->nPreChecked = 0;                                                     /* holding area is empty */
+    sh->doorbell = false;
 
     /* initialize problem internal status */
 
-    createLog (nFic);                                                                             /* log file creation */
+    createLog (nFic, &sh->fSt);                                                                   /* log file creation */
 
     /* initialize semaphore ids */
 
     sh->mutex = MUTEX;                                                              /* mutual exclusion semaphore id */
-    sh->passengersInQueue = PASSENGERSINQUEUE;                                       
+    sh->passengersInQueue[0] = PASSENGERSINQUEUE;                                       
+    for (t = 1; t < MAXDEST; t++)                                   /* semaphores of the other destinations */
+        sh->passengersInQueue[t] = DESTSEMS + t - 1;
     sh->passengersWaitInQueue = PASSENGERSWAITINQUEUE;                              
-    sh->passengersWaitInFlight = PASSENGERSWAITINFLIGHT;                           
+    sh->passengersWaitInFlight[0] = PASSENGERSWAITINFLIGHT;                           
     sh->readyForBoarding = READYFORBOARDING;                                      
-    sh->readyToFlight = READYTOFLIGHT;                                           
+    sh->readyToFlight[0] = READYTOFLIGHT;                                           
     sh->idShown = IDSHOWN;                                                      
-    sh->planeEmpty = PLANEEMPTY;                                                      
+    sh->planeEmpty[0] = PLANEEMPTY;                                                      
+    for (t = 1; t < MAXPL; t++) {                                          /* semaphores of the other planes */
+        sh->passengersWaitInFlight[t] = PLANESEMS + 3 * (t - 1);
+        sh->readyToFlight[t] = PLANESEMS + 3 * (t - 1) + 1;
+        sh->planeEmpty[t] = PLANESEMS + 3 * (t - 1) + 2;
+    }
+    sh->gate = GATE;
+    sh->checkDone = CHECKDONE;
 
     /* creating and initializing the semaphore set */
 
-    if ((semgid = semCreate (key, SEM_NU)) == -1) { 
+    if ((semgid = semCreate (key, (par.fastBoarding) ? SEM_NU_FAST : SEM_NU)) == -1) { 
         perror ("error on creating the semaphore set");
         exit (EXIT_FAILURE);
     }
+    if (par.eventFd) {                                         /* one inherited event file descriptor per semaphore */
+        if ((getrlimit (RLIMIT_NOFILE, &fdLimit) == 0) && (fdLimit.rlim_cur < fdLimit.rlim_max)) {
+            fdLimit.rlim_cur = fdLimit.rlim_max;
+            setrlimit (RLIMIT_NOFILE, &fdLimit);
+        }
+        if (semEventCreate (sh->eventFd, (par.fastBoarding) ? SEM_NU_FAST : SEM_NU) == -1) {
+            perror ("error on creating the event file descriptors");
+            semDestroy (semgid);
+            shmemDestroy (shmid);
+            exit (EXIT_FAILURE);
+        }
+        semUseEvents (sh->eventFd);
+    }
     if (semUp (semgid, sh->mutex) == -1) {                                      /* enabling access to critical region */
         perror ("error on executing the up operation for semaphore access");
         exit (EXIT_FAILURE);
     }
+    if (semUp (semgid, sh->gate) == -1) {                                                /* boarding gate is free */
+        perror ("error on executing the up operation for semaphore access");
+        exit (EXIT_FAILURE);
+    }
 
     /* generation of intervening entities processes */
 
-    strcpy (nFicErr + 6, "PG");
-    for (p = 0; p < N; p++) {                                                                  /* passenger processes */
-        if ((pidPG[p] = fork ()) < 0) {
-            perror ("error on the fork operation for the passenger");
+    if (acctInit (((par.jitSpawn) ? N : nPG) + par.nHostess + par.nPlanes + 1) == -1) {
+        perror ("error on allocating the resource accounting");
+        exit (EXIT_FAILURE);
+    }
+    if (!par.jitSpawn) {
+        first = 0;
+        for (p = 0; p < nPG; p++) {                                               /* passenger (or worker) processes */
+            pidPG[p] = spawnPassenger (first, first + (N - first) / (nPG - p) - 1, nFic, num[1], &sh->fSt.par.sched);
+            first += (N - first) / (nPG - p);
+        }
+    }
+
+    for (h = 0; h < par.nHostess; h++) {
+        if (par.nHostess == 1)
+            strcpy (nFicErr + 6, "HT");
+        else sprintf (nFicErr + 6, "HT%u", h);
+        sprintf (num[0], "%u", h);
+        if ((pidHT[h] = fork ()) < 0)  {                                                        /* hostess process */
+            perror ("error on the fork operation for the hostess");
             exit (EXIT_FAILURE);
         }
-        sprintf(num[0],"%d",p);
-        sprintf(nFicErr+8,"%02d",p); 
-        if (pidPG[p] == 0)
-            if (execl (PASSENGER, PASSENGER, num[0], nFic, num[1],nFicErr, NULL) < 0) { 
-                perror ("error on the generation of the passenger process");
+        if (pidHT[h] == 0) {
+            applyPolicy (&sh->fSt.par.sched, ACCT_HOSTESS);
+            if (execl (HOSTESS, HOSTESS, nFic, num[1], nFicErr, num[0], NULL) < 0) {
+                perror ("error on the generation of the hostess process");
                 exit (EXIT_FAILURE);
             }
+        }
+        acctSpawned (pidHT[h], ACCT_HOSTESS, h, h);
     }
 
-    strcpy (nFicErr + 6, "HT");
-    if ((pidHT = fork ()) < 0)  {                                                               /* hostess process */
-        perror ("error on the fork operation for the hostess");
-        exit (EXIT_FAILURE);
-    }
-    if (pidHT == 0) {
-        if (execl (HOSTESS, HOSTESS, nFic, num[1], nFicErr, NULL) < 0) {
-            perror ("error on the generation of the hostess process");
+    for (t = 0; t < par.nPlanes; t++) {
+        if (par.nPlanes == 1)
+            strcpy (nFicErr + 6, "PT");
+        else sprintf (nFicErr + 6, "PT%u", t);
+        sprintf (num[0], "%u", t);
+        if ((pidPT[t] = fork ()) < 0) {                                                            /* pilot process */
+            perror ("error on the fork operation for the pilot");
             exit (EXIT_FAILURE);
         }
+        if (pidPT[t] == 0) {
+            applyPolicy (&sh->fSt.par.sched, ACCT_PILOT);
+            if (execl (PILOT, PILOT, nFic, num[1], nFicErr, num[0], NULL) < 0) { 
+                perror ("error on the generation of the referee process");
+                exit (EXIT_FAILURE);
+            }
+        }
+        acctSpawned (pidPT[t], ACCT_PILOT, t, t);
     }
 
-    strcpy (nFicErr + 6, "PT");
-    if ((pidPT = fork ()) < 0) {                                                                   /* pilot process */
-        perror ("error on the fork operation for the pilot");
-        exit (EXIT_FAILURE);
-    }
-    if (pidPT == 0)
-        if (execl (PILOT, PILOT, nFic, num[1], nFicErr, NULL) < 0) { 
-            perror ("error on the generation of the referee process");
+    if (par.stall > 0.0) {
+        strcpy (nFicErr + 6, "WD");
+        if ((pidWD = fork ()) < 0) {                                                            /* watchdog process */
+            perror ("error on the fork operation for the watchdog");
             exit (EXIT_FAILURE);
         }
+        if (pidWD == 0)
+            if (execl (WATCHDOG, WATCHDOG, nFic, num[1], nFicErr, NULL) < 0) {
+                perror ("error on the generation of the watchdog process");
+                exit (EXIT_FAILURE);
+            }
+        acctSpawned (pidWD, ACCT_WATCHDOG, 0, 0);
+    }
 
     /* signaling start of operations */
 
+    clock_gettime (CLOCK_MONOTONIC, &sh->start);
     if (semSignal (semgid) == -1) {
         perror ("error on signaling start of operations");
         exit (EXIT_FAILURE);
     }
 
-    /* waiting for the termination of the intervening entities processes */
+    /* passengers are spawned upon arrival at the airport */
 
     m = 0;
-    do {
-        info = wait (&status);
-        if (info == -1)
-        { perror ("error on waiting for an intervening process");
-            exit (EXIT_FAILURE);
-        }
-        m += 1;
-    } while (m < N+2);
+    if (par.jitSpawn)
+        m = scheduleArrivals (sh, nFic, num[1], pidPG);
+
+    /* service mode: throughput reporting until the run is stopped */
+
+    if (par.service)
+        m += serveUntilStop (sh, nFic, interval, pidPT);
+
+    /* waiting for the termination of the intervening entities processes */
+
+    while (m < nPG + par.nHostess + par.nPlanes)
+        m += reapChildren (true);
+    if ((pidWD != -1) && !acctIsReaped (pidWD)) {
+        kill (pidWD, SIGTERM);
+        while (!acctIsReaped (pidWD))
+            reapChildren (true);
+    }
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    makespan = (now.tv_sec - sh->start.tv_sec) + (now.tv_nsec - sh->start.tv_nsec) / 1e9;
 
     saveAirLiftResult(nFic,&sh->fSt);
+    saveWaits (nFic, &sh->fSt.par.departure, &sh->wait);
+    if (par.classes.bound > 0)
+        saveClassWaits (nFic, &sh->fSt.par.classes, sh->queueWait);
+    if (par.nDest > 1)
+        saveRoutes (nFic, &sh->fSt, makespan);
+    saveLoad (nFic, arrivalOfferedLoad (sh->arrival, N), sh->fSt.totalPassBoarded / makespan, makespan);
+    saveSemOps (nFic, sh->semOps, sh->fSt.totalPassBoarded);
+    if (par.mailbox)
+        saveMessages (nFic, sh->msgOps, sh->fSt.totalPassBoarded);
+    if (par.lockStats)
+        saveCritRegions (nFic, &sh->crProf);
+    savePolicy (nFic, &sh->fSt.par.sched);
+    acctReport (nFic);
+    acctFree ();
 
     /* destruction of semaphore set and shared region */
 
@@ -197,6 +669,10 @@ int main (int argc, char *argv[])
         perror ("error on destructing the semaphore set");
         exit (EXIT_FAILURE);
     }
+    if (par.eventFd) {
+        semUseEvents (NULL);
+        semEventClose (sh->eventFd, (par.fastBoarding) ? SEM_NU_FAST : SEM_NU);
+    }
     if (shmemDettach (sh) == -1) { 
         perror ("error on unmapping the shared region off the process address space");
         exit (EXIT_FAILURE);
@@ -208,3 +684,471 @@ int main (int argc, char *argv[])
 
     return EXIT_SUCCESS;
 }
+
+/**
+ *  \brief Printing the command line syntax.
+ *
+ *  \param name program name
+ */
+
+static void usage (char *name)
+{
+    fprintf (stderr, "USAGE: %s [options] [log-file]\n"
+                     "  -a, --arrivals=SPEC     arrival process: uniform, poisson:RATE, constant:RATE or\n"
+                     "                          onoff:RATE:ON:OFF (passengers/s, s) or trace:FILE\n"
+                     "  -b, --batch=K           hostess checks up to K queued passengers at once (implies -F)\n"
+                     "  -C, --cpus=ROLE:CPUS    restrict pilot, hostess or passengers to a processor list\n"
+                     "  -c, --clean             remove leftover semaphore set and shared memory, and exit\n"
+                     "  -D, --departure=POLICY  departure policy: minfc, hold:SECS or target:U\n"
+                     "  -E, --eventfd           entities wait on event file descriptors instead of semaphores\n"
+                     "  -F, --fast              reduced-handshake boarding protocol\n"
+                     "  -j, --jit               spawn each passenger upon arrival at the airport\n"
+                     "  -S, --service           continuous service mode (requires -d or -f)\n"
+                     "  -d, --duration=SECS     duration of a service mode run\n"
+                     "  -f, --flights=F         number of flights of a service mode run\n"
+                     "  -G, --groups=K          passengers travel in parties of up to K (implies -F)\n"
+                     "  -H, --hostesses=H       H hostesses board each flight in parallel (implies -F)\n"
+                     "  -K, --classes=C:N[:B]   priority boarding: shares of crew and connections, starvation\n"
+                     "                          bound B (implies -F)\n"
+                     "  -l, --lockstats         per call site wait and hold time of the critical regions\n"
+                     "  -L, --lockfree          passengers publish their ids in a lock-free queue (implies -F)\n"
+                     "  -M, --mailbox           entities exchange messages through mailboxes (implies -F)\n"
+                     "  -P, --planes=P          fleet of P planes, each one with its own pilot\n"
+                     "  -p, --preboard          pre-check passports while the plane is away (implies -F)\n"
+                     "  -T, --destinations=D[:POLICY]\n"
+                     "                          D destinations, routing policy longest or cyclic (implies -F)\n"
+                     "  -i, --interval=SECS     throughput reporting interval (default 1)\n"
+                     "  -r, --priority=CLASS    raise pilot and hostess priority: nice or fifo\n"
+                     "  -s, --seed=SEED         master seed of the run\n"
+                     "  -W, --watchdog=SECS     abort the run after SECS without progress\n"
+                     "  -w, --workers[=W]       host the passengers in W worker processes\n", name);
+}
+
+/**
+ *  \brief Removal of the leftovers of a crashed run.
+ *
+ *  A shared memory region or a semaphore set with the access key of this run is only removed if the process that
+ *  created the region and the last processes that operated on the semaphores are no longer alive. Otherwise,
+ *  another run is in progress and the launcher gives up.
+ *
+ *  \param key access key to shared memory and semaphore set
+ */
+
+static void removeStaleIpc (int key)
+{
+    int oldShmid, oldSemgid;                                          /* identifiers of the leftover IPC resources */
+    int pid;                                                                                   /* process identifier */
+    unsigned int s;
+
+    oldShmid = shmemConnect (key);
+    oldSemgid = semLookup (key);
+    if ((oldShmid == -1) && (oldSemgid == -1))
+        return;
+
+    /* checking the owners are dead */
+
+    pid = (oldShmid != -1) ? shmemCreatorPid (oldShmid) : 0;
+    for (s = 0; ; s++) {
+        if ((pid > 0) && ((kill (pid, 0) == 0) || (errno != ESRCH))) {
+            fprintf (stderr, "Shared memory region / semaphore set with key 0x%08x in use by process %d!\n", key, pid);
+            exit (EXIT_FAILURE);
+        }
+        if ((oldSemgid == -1) || ((pid = semLastPid (oldSemgid, s)) == -1))
+            break;                                                         /* all semaphores in the set checked */
+    }
+
+    if ((oldShmid != -1) && (shmemDestroy (oldShmid) == -1)) {
+        perror ("error on destructing the leftover shared region");
+        exit (EXIT_FAILURE);
+    }
+    if ((oldSemgid != -1) && (semDestroy (oldSemgid) == -1)) {
+        perror ("error on destructing the leftover semaphore set");
+        exit (EXIT_FAILURE);
+    }
+    fprintf (stderr, "Removed leftover shared memory region / semaphore set with key 0x%08x\n", key);
+}
+
+/**
+ *  \brief Termination signals handler.
+ *
+ *  The intervening entities are terminated, the semaphore set and the shared memory region are removed and the
+ *  launcher terminates with the received signal.
+ *
+ *  \param sig signal number
+ */
+
+static void abortRun (int sig)
+{
+    if (getpid () != pidLauncher)                                           /* child between fork and exec */
+        _exit (EXIT_FAILURE);
+    acctKill (SIGTERM);
+    if (semgid != -1)
+        semDestroy (semgid);
+    if (shmid != -1)
+        shmemDestroy (shmid);
+    signal (sig, SIG_DFL);
+    raise (sig);
+}
+
+/**
+ *  \brief Parsing of a processor affinity option.
+ *
+ *  \param spec option argument, <em>role</em><tt>:</tt><em>cpus</em>
+ *  \param sp scheduling policy of the run
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the role or the processor list is wrong
+ */
+
+static int parseCpus (char *spec, SCHED_POLICY *sp)
+{
+    static const char *roles[] = {"pilot", "hostess", "passengers"};
+    char *cpus;                                                                                /* processor list */
+    unsigned int r;
+
+    if ((cpus = strchr (spec, ':')) == NULL)
+        return -1;
+    *cpus++ = '\0';
+    for (r = 0; r < 3; r++)
+        if (strcmp (spec, roles[r]) == 0)
+            break;
+    if ((r == 3) || (strlen (cpus) >= MAXCPULIST) || (policyCheck (cpus) == -1))
+        return -1;
+    strcpy (sp->cpus[r], cpus);
+    return 0;
+}
+
+/**
+ *  \brief Application of the scheduling policy of a role.
+ *
+ *  It is called by the child process between fork and exec. Only the pilot and the hostess have their
+ *  scheduling class raised; the class actually applied is recorded in the shared region for the final summary.
+ *
+ *  \param sp scheduling policy of the run (in the shared region)
+ *  \param role role of the intervening entity (ACCT_PILOT, ACCT_HOSTESS or ACCT_PASSENGER)
+ */
+
+static void applyPolicy (SCHED_POLICY *sp, unsigned int role)
+{
+    int prio;                                                                      /* scheduling class applied */
+
+    if ((prio = policyApply (sp->cpus[role], (role == ACCT_PASSENGER) ? PRIO_NONE : sp->prio)) == -1) {
+        perror ("error on setting the processor affinity");
+        exit (EXIT_FAILURE);
+    }
+    if (role != ACCT_PASSENGER)
+        sp->applied[role] = (unsigned int) prio;
+}
+
+/**
+ *  \brief Generation of one passenger process.
+ *
+ *  The process hosts the passengers <tt>first</tt> to <tt>last</tt>; it is a worker process if there is more
+ *  than one.
+ *
+ *  \param first id of the first passenger
+ *  \param last id of the last passenger
+ *  \param nFic name of the logging file
+ *  \param key access key to shared memory and semaphore set (textual form)
+ *  \param sp scheduling policy of the run
+ *
+ *  \return process identifier of the passenger
+ */
+
+static int spawnPassenger (unsigned int first, unsigned int last, char nFic[], char key[], SCHED_POLICY *sp)
+{
+    char nFicErr[] = "error_        ";                                                      /* name of error file */
+    char num[24];                                                     /* passenger id or range of ids (first-last) */
+    int pid;                                                                                   /* process identifier */
+
+    if (first == last) {
+        sprintf (num, "%u", first);
+        sprintf (nFicErr + 6, "PG%02u", first);
+    }
+    else {
+        sprintf (num, "%u-%u", first, last);
+        sprintf (nFicErr + 6, "PW%02u", first);
+    }
+    if ((pid = fork ()) < 0) {
+        perror ("error on the fork operation for the passenger");
+        exit (EXIT_FAILURE);
+    }
+    if (pid == 0) {
+        applyPolicy (sp, ACCT_PASSENGER);
+        if (execl (PASSENGER, PASSENGER, num, nFic, key, nFicErr, NULL) < 0) {
+            perror ("error on the generation of the passenger process");
+            exit (EXIT_FAILURE);
+        }
+    }
+    acctSpawned (pid, ACCT_PASSENGER, first, last);
+    return pid;
+}
+
+/**
+ *  \brief Formation of the parties of passengers.
+ *
+ *  Consecutive passenger ids are grouped in parties whose sizes are drawn uniformly in [1, <tt>maxGroup</tt>] from a
+ *  launcher stream. A party is identified by the id of its first member, and all the members take its arrival time,
+ *  so they reach the airport together. Without parties every passenger is a party of one.
+ *
+ *  \param sh pointer to shared memory region
+ *  \param maxGroup max size of a party
+ *  \param seed master seed of the run
+ */
+
+static void formGroups (SHARED_DATA *sh, unsigned int maxGroup, uint64_t seed)
+{
+    PRNG rng;                                                                          /* party sizes generator */
+    unsigned int p, m, size;
+
+    prngInit (&rng, prngSeed (seed, SEED_LAUNCHER, 1));
+    for (p = 0; p < N; p += size) {
+        size = 1;
+        if (maxGroup > 1) {
+            size += (unsigned int) (prngUniform (&rng) * maxGroup);
+            if (size > maxGroup)
+                size = maxGroup;
+        }
+        if (p + size > N)
+            size = N - p;
+        sh->groupSize[p] = size;
+        sh->gathered[p] = 0;
+        for (m = p; m < p + size; m++) {
+            sh->group[m] = p;
+            sh->arrival[m] = sh->arrival[p];
+        }
+    }
+}
+
+/**
+ *  \brief Assignment of the priority classes of the passengers.
+ *
+ *  The class of each party is drawn from a launcher stream according to the shares of the classes, and taken by all
+ *  its members, so a party is queued together in the queue of its class. Without priority classes every passenger is
+ *  general.
+ *
+ *  \param sh pointer to shared memory region
+ *  \param cp pointer to the priority classes of the run
+ *  \param seed master seed of the run
+ */
+
+static void assignClasses (SHARED_DATA *sh, CLASS_POLICY *cp, uint64_t seed)
+{
+    PRNG rng;                                                                               /* classes generator */
+    unsigned int p, c;
+    double u;
+
+    prngInit (&rng, prngSeed (seed, SEED_LAUNCHER, 2));
+    for (p = 0; p < N; p++) {
+        if (sh->group[p] != p)                                          /* member of a party, as its first member */
+            c = sh->priority[sh->group[p]];
+        else if (cp->bound == 0)
+            c = CLASS_GENERAL;
+        else {
+            u = prngUniform (&rng);
+            for (c = 0; (c < CLASS_GENERAL) && (u >= cp->share[c]); c++)
+                u -= cp->share[c];
+        }
+        sh->priority[p] = c;
+    }
+}
+
+/**
+ *  \brief Assignment of the destinations of the passengers.
+ *
+ *  The destination of each party is drawn uniformly from a launcher stream and taken by all its members, so a party
+ *  is queued together in the queue of its destination. The number of passengers flying to each destination is
+ *  counted in its route.
+ *
+ *  \param sh pointer to shared memory region
+ *  \param nDest number of destinations
+ *  \param seed master seed of the run
+ */
+
+static void assignDestinations (SHARED_DATA *sh, unsigned int nDest, uint64_t seed)
+{
+    PRNG rng;                                                                          /* destinations generator */
+    unsigned int p, d;
+
+    prngInit (&rng, prngSeed (seed, SEED_LAUNCHER, 3));
+    memset (sh->fSt.route, 0, sizeof (sh->fSt.route));
+    for (p = 0; p < N; p++) {
+        if (sh->group[p] != p)                                          /* member of a party, as its first member */
+            d = sh->destination[sh->group[p]];
+        else {
+            d = (unsigned int) (prngUniform (&rng) * nDest);
+            if (d >= nDest)
+                d = nDest - 1;
+        }
+        sh->destination[p] = d;
+        sh->fSt.route[d].nPass++;
+    }
+}
+
+/**
+ *  \brief Just-in-time spawning of the passengers.
+ *
+ *  The launcher keeps the arrival times of the passengers in a min-heap and spawns each passenger only when it
+ *  reaches the airport. Terminated processes are reaped while waiting for the next arrival, so the number of live
+ *  processes is bounded by the passengers in queue and in flight.
+ *
+ *  \param sh pointer to shared memory region
+ *  \param nFic name of the logging file
+ *  \param key access key to shared memory and semaphore set (textual form)
+ *  \param pidPG passengers processes identifier array
+ *
+ *  \return number of intervening processes already reaped
+ */
+
+static unsigned int scheduleArrivals (SHARED_DATA *sh, char nFic[], char key[], int pidPG[])
+{
+    MIN_HEAP arrivals;                                                                 /* pending passenger arrivals */
+    HEAP_ITEM next;                                                                              /* next arrival */
+    struct timespec at;                                                                           /* arrival deadline */
+    unsigned int p, m = 0;
+
+    if (heapInit (&arrivals, N) == -1) {
+        perror ("error on allocating the arrival schedule");
+        exit (EXIT_FAILURE);
+    }
+    for (p = 0; p < N; p++)
+        heapPush (&arrivals, sh->arrival[p], p);
+
+    while (heapPop (&arrivals, &next) == 0) {
+        arrivalDeadline (&sh->start, next.time, &at);
+        m += reapChildren (false);
+        if (sleepUntil (&at) == -1) {
+            perror ("error on waiting for the arrival of a passenger");
+            exit (EXIT_FAILURE);
+        }
+        pidPG[next.id] = spawnPassenger (next.id, next.id, nFic, key, &sh->fSt.par.sched);
+    }
+    heapFree (&arrivals);
+
+    return m;
+}
+
+/**
+ *  \brief Reaping of terminated intervening processes.
+ *
+ *  Their exit status and resource usage are recorded for the final summary.
+ *
+ *  \param block wait for at least one process to terminate
+ *
+ *  \return number of processes reaped, not counting the watchdog
+ */
+
+static unsigned int reapChildren (bool block)
+{
+    int status;                                                                                  /* execution status */
+    int info;                                                                                                /* info id */
+    struct rusage ru;                                                                                /* resource usage */
+    unsigned int m = 0;
+    bool first = true;                                                                  /* no process was reaped yet */
+
+    do {
+        info = wait4 (-1, &status, (block && first) ? 0 : WNOHANG, &ru);
+        if ((info == -1) && (errno == ECHILD) && !(block && first))
+            break;                                                                     /* no intervening processes left */
+        if (info == -1) {
+            perror ("error on waiting for an intervening process");
+            exit (EXIT_FAILURE);
+        }
+        if (info > 0) {
+            first = false;
+            if (acctReaped (info, status, &ru) != ACCT_WATCHDOG)
+                m += 1;
+        }
+    } while (info > 0);
+
+    return m;
+}
+
+/**
+ *  \brief Throughput reporting in service mode.
+ *
+ *  Every <tt>interval</tt> seconds the number of passengers boarded and of flights since the previous report are
+ *  written to the log as rates; the last report comes when the configured duration elapses, even within an interval.
+ *  The launcher then asks the pilots to stop, and the flight being boarded departs with the passengers on board. The
+ *  run also stops when the pilot completes the configured number of flights; the launcher then waits for the pilots
+ *  and terminates the remaining entities.
+ *  The steady-state rates, which exclude the first interval, are written at the end.
+ *
+ *  \param sh pointer to shared memory region
+ *  \param nFic name of the logging file
+ *  \param interval reporting interval (s)
+ *  \param pidPT pilot process identifier array
+ *
+ *  \return number of intervening processes already reaped
+ */
+
+static unsigned int serveUntilStop (SHARED_DATA *sh, char nFic[], double interval, int pidPT[])
+{
+    struct timespec start, at, now;                                                 /* start of service, next report */
+    double elapsed, prevElapsed = 0.0;                                                           /* elapsed time (s) */
+    unsigned int boarded, flights,                                                             /* current counters */
+                 prevBoarded = 0, prevFlights = 0,                                     /* counters at previous report */
+                 warmBoarded = 0, warmFlights = 0;                                    /* counters at end of warm-up */
+    double warmElapsed = 0.0;
+    double next = 0.0;                                                   /* time of the next report since the start */
+    unsigned int m = 0, t;
+    bool stop = false;
+
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    while (!stop) {
+        next += interval;
+        if ((sh->fSt.par.duration > 0.0) && (next > sh->fSt.par.duration))
+            next = sh->fSt.par.duration;                                        /* the run ends within the interval */
+        at.tv_sec = start.tv_sec + (time_t) next;
+        at.tv_nsec = start.tv_nsec + (long) ((next - (time_t) next) * 1e9);
+        if (at.tv_nsec >= 1000000000) {
+            at.tv_sec += 1;
+            at.tv_nsec -= 1000000000;
+        }
+        if (sleepUntil (&at) == -1) {
+            perror ("error on waiting for the next throughput report");
+            exit (EXIT_FAILURE);
+        }
+        m += reapChildren (false);
+        clock_gettime (CLOCK_MONOTONIC, &now);
+        elapsed = (now.tv_sec - start.tv_sec) + (now.tv_nsec - start.tv_nsec) / 1e9;
+
+        if (semDown (semgid, sh->mutex) == -1) {
+            perror ("error on the down operation for semaphore access (main)");
+            exit (EXIT_FAILURE);
+        }
+        if ((sh->fSt.par.duration > 0.0) && (elapsed >= sh->fSt.par.duration))
+            sh->fSt.finished = true;                    /* the pilot stops, the flight at the gate departs as it is */
+        stop = sh->fSt.finished;
+        boarded = sh->fSt.totalPassBoarded;
+        flights = sh->fSt.nFlight;
+        if (semUp (semgid, sh->mutex) == -1) {
+            perror ("error on the up operation for semaphore access (main)");
+            exit (EXIT_FAILURE);
+        }
+
+        saveThroughput (nFic, elapsed, (boarded - prevBoarded) / (elapsed - prevElapsed),
+                        (flights - prevFlights) / (elapsed - prevElapsed));
+        if (prevElapsed == 0.0) {
+            warmBoarded = boarded;
+            warmFlights = flights;
+            warmElapsed = elapsed;
+        }
+        prevBoarded = boarded;
+        prevFlights = flights;
+        prevElapsed = elapsed;
+    }
+
+    /* the pilots complete the current flights; the other entities are then terminated */
+
+    for (t = 0; t < sh->fSt.par.nPlanes; t++)
+        while (!acctIsReaped (pidPT[t]))
+            m += reapChildren (true);
+    acctKill (SIGTERM);
+
+    if (elapsed > warmElapsed)
+        saveSteadyState (nFic, elapsed - warmElapsed, (boarded - warmBoarded) / (elapsed - warmElapsed),
+                         (flights - warmFlights) / (elapsed - warmElapsed));
+
+    return m;
+}
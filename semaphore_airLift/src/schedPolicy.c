@@ -0,0 +1,147 @@
+/**
+ *  \file schedPolicy.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Processor affinity and scheduling class of the intervening entities.
+ *
+ *  The launcher applies the policy of each role in the child process, between fork and exec, so it is inherited by
+ *  the entity program and by the threads it creates. A scheduling class that is not permitted falls back to the next
+ *  weaker one (real-time FIFO, raised nice value, default class).
+ *
+ *  Defined operations:
+ *     \li validation of a processor list
+ *     \li application of a policy to the calling process
+ *     \li name of a scheduling class.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <errno.h>
+#include <sched.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "probConst.h"
+#include "schedPolicy.h"
+
+/** \brief nice value of a raised role */
+#define  NICE_RAISED   -10
+
+/** \brief scheduling class names */
+static const char *prioName[] = {"default", "nice", "fifo"};
+
+/**
+ *  \brief Parsing of a processor list.
+ *
+ *  \param cpus processor list
+ *  \param set processor set
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the list is malformed (<tt>errno</tt> is set to <tt>EINVAL</tt>)
+ */
+
+static int parseList (const char *cpus, cpu_set_t *set)
+{
+    const char *p = cpus;
+    char *end;
+    unsigned long lo, hi;
+
+    CPU_ZERO (set);
+    do {
+        lo = strtoul (p, &end, 10);
+        if (end == p)
+            break;
+        hi = lo;
+        if (*end == '-') {
+            p = end + 1;
+            hi = strtoul (p, &end, 10);
+            if (end == p)
+                break;
+        }
+        if ((lo > hi) || (hi >= CPU_SETSIZE))
+            break;
+        for (; lo <= hi; lo++)
+            CPU_SET (lo, set);
+        if (*end == '\0')
+            return 0;
+        p = end + 1;
+    } while (*end == ',');
+
+    errno = EINVAL;
+    return -1;
+}
+
+/**
+ *  \brief Validation of a processor list.
+ *
+ *  A list is a comma separated sequence of processor numbers or ranges (<tt>0-3,6</tt>). It is valid if it is well
+ *  formed and names at least one processor the calling process is allowed to run on.
+ *
+ *  \param cpus processor list
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int policyCheck (const char *cpus)
+{
+    cpu_set_t set, allowed;
+
+    if (parseList (cpus, &set) == -1)
+        return -1;
+    if (sched_getaffinity (0, sizeof (allowed), &allowed) == -1)
+        return -1;
+    CPU_AND (&set, &set, &allowed);
+    if (CPU_COUNT (&set) == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ *  \brief Application of a policy to the calling process.
+ *
+ *  \param cpus processor list (empty string if unrestricted)
+ *  \param prio scheduling class requested (PRIO_NONE, PRIO_NICE or PRIO_FIFO)
+ *
+ *  \return scheduling class applied, upon success
+ *  \return -\c 1, when the processor affinity can not be set (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int policyApply (const char *cpus, unsigned int prio)
+{
+    cpu_set_t set;
+    struct sched_param sp;
+
+    if (cpus[0] != '\0') {
+        if ((parseList (cpus, &set) == -1) || (sched_setaffinity (0, sizeof (set), &set) == -1))
+            return -1;
+    }
+    if (prio == PRIO_FIFO) {
+        sp.sched_priority = sched_get_priority_min (SCHED_FIFO);
+        if (sched_setscheduler (0, SCHED_FIFO, &sp) == 0)
+            return PRIO_FIFO;
+        prio = PRIO_NICE;                                                      /* not permitted, falling back */
+    }
+    if (prio == PRIO_NICE) {
+        if (setpriority (PRIO_PROCESS, 0, NICE_RAISED) == 0)
+            return PRIO_NICE;
+    }
+    return PRIO_NONE;
+}
+
+/**
+ *  \brief Name of a scheduling class.
+ *
+ *  \param prio scheduling class
+ *
+ *  \return printable name
+ */
+
+const char *policyName (unsigned int prio)
+{
+    return (prio <= PRIO_FIFO) ? prioName[prio] : "?";
+}
@@ -0,0 +1,57 @@
+/**
+ *  \file schedPolicy.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Processor affinity and scheduling class of the intervening entities.
+ *
+ *  The launcher applies the policy of each role in the child process, between fork and exec, so it is inherited by
+ *  the entity program and by the threads it creates. A scheduling class that is not permitted falls back to the next
+ *  weaker one (real-time FIFO, raised nice value, default class).
+ *
+ *  Defined operations:
+ *     \li validation of a processor list
+ *     \li application of a policy to the calling process
+ *     \li name of a scheduling class.
+ */
+
+#ifndef SCHEDPOLICY_H_
+#define SCHEDPOLICY_H_
+
+/**
+ *  \brief Validation of a processor list.
+ *
+ *  A list is a comma separated sequence of processor numbers or ranges (<tt>0-3,6</tt>). It is valid if it is well
+ *  formed and names at least one processor the calling process is allowed to run on.
+ *
+ *  \param cpus processor list
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int policyCheck (const char *cpus);
+
+/**
+ *  \brief Application of a policy to the calling process.
+ *
+ *  \param cpus processor list (empty string if unrestricted)
+ *  \param prio scheduling class requested (PRIO_NONE, PRIO_NICE or PRIO_FIFO)
+ *
+ *  \return scheduling class applied, upon success
+ *  \return -\c 1, when the processor affinity can not be set (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int policyApply (const char *cpus, unsigned int prio);
+
+/**
+ *  \brief Name of a scheduling class.
+ *
+ *  \param prio scheduling class
+ *
+ *  \return printable name
+ */
+
+extern const char *policyName (unsigned int prio);
+
+#endif /* SCHEDPOLICY_H_ */
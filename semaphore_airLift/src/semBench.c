@@ -0,0 +1,150 @@
+/**
+ *  \file semBench.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  \brief Wakeup latency of the semaphore backends.
+ *
+ *  Two processes play ping-pong on a pair of semaphores: the first one <em>up</em>s the first semaphore and
+ *  waits on the second, the other one waits on the first and <em>up</em>s the second. Half of each round trip
+ *  is the time a process takes to wake up a blocked one. The rounds are run first on a SVIPC semaphore set
+ *  (<tt>semop</tt>) and then on event file descriptors (<tt>eventfd</tt>), through the same operations used by the
+ *  intervening entities, and the mean and percentiles of the wakeup latency of each backend are written to stdout.
+ *
+ *  Upon execution, one optional parameter is accepted:
+ *    \li number of rounds per backend (default ROUNDS).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/types.h>
+#include <sys/ipc.h>
+
+#include "probConst.h"
+#include "semaphore.h"
+#include "histogram.h"
+
+/** \brief default number of rounds per backend */
+#define  ROUNDS         20000
+
+/** \brief number of rounds run before measuring */
+#define  WARMUP         1000
+
+/** \brief semaphore waited on by the responder */
+#define  PING           1
+
+/** \brief semaphore waited on by the initiator */
+#define  PONG           2
+
+static int pingPong (int semgid, unsigned int rounds, HISTOGRAM *h);
+
+/**
+ *  \brief Main program.
+ *
+ *  Its role is measuring the wakeup latency of both backends and printing the results.
+ */
+
+int main (int argc, char *argv[])
+{
+    static const char *backend[] = {"semop", "eventfd"};
+    int semgid;                                                                           /* semaphore set identifier */
+    int fd[PONG + 1];                                                                       /* event file descriptors */
+    unsigned int rounds = ROUNDS;
+    unsigned int b;
+    HISTOGRAM h;                                                                               /* wakeup latency (ns) */
+    char *tinp;                                                                     /* numerical parameters test flag */
+
+    if (argc > 2) {
+        fprintf (stderr, "USAGE: %s [rounds]\n", argv[0]);
+        exit (EXIT_FAILURE);
+    }
+    if (argc == 2) {
+        rounds = (unsigned int) strtol (argv[1], &tinp, 0);
+        if ((*tinp != '\0') || (rounds == 0)) {
+            fprintf (stderr, "Number of rounds is wrong!\n");
+            exit (EXIT_FAILURE);
+        }
+    }
+
+    if ((semgid = semCreate (IPC_PRIVATE, PONG)) == -1) {
+        perror ("error on creating the semaphore set");
+        exit (EXIT_FAILURE);
+    }
+    if (semEventCreate (fd, PONG) == -1) {
+        perror ("error on creating the event file descriptors");
+        semDestroy (semgid);
+        exit (EXIT_FAILURE);
+    }
+
+    printf ("%-8s %8s %10s %10s %10s %10s (us)\n", "backend", "rounds", "mean", "p50", "p99", "max");
+    for (b = 0; b < 2; b++) {
+        semUseEvents ((b == 0) ? NULL : fd);
+        memset (&h, 0, sizeof (h));
+        if (pingPong (semgid, rounds, &h) == -1) {
+            perror ("error on the ping-pong rounds");
+            semEventClose (fd, PONG);
+            semDestroy (semgid);
+            exit (EXIT_FAILURE);
+        }
+        printf ("%-8s %8u %10.2f %10.2f %10.2f %10.2f\n", backend[b], rounds, histMean (&h) / 1e3,
+                histPercentile (&h, 0.50) / 1e3, histPercentile (&h, 0.99) / 1e3, h.max / 1e3);
+    }
+
+    semEventClose (fd, PONG);
+    if (semDestroy (semgid) == -1) {
+        perror ("error on destructing the semaphore set");
+        exit (EXIT_FAILURE);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ *  \brief Ping-pong rounds on the backend in use.
+ *
+ *  \param semgid semaphore set identifier
+ *  \param rounds number of measured rounds
+ *  \param h histogram where the wakeup latency of each round is recorded (ns)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+static int pingPong (int semgid, unsigned int rounds, HISTOGRAM *h)
+{
+    struct timespec t0, t1;
+    unsigned int r;
+    int pid, status;
+
+    if ((pid = fork ()) < 0)
+        return -1;
+    if (pid == 0) {                                                                /* responder, inherits the backend */
+        for (r = 0; r < WARMUP + rounds; r++)
+            if ((semDown (semgid, PING) == -1) || (semUp (semgid, PONG) == -1)) {
+                perror ("error on the responder rounds");
+                _exit (EXIT_FAILURE);
+            }
+        _exit (EXIT_SUCCESS);
+    }
+
+    for (r = 0; r < WARMUP + rounds; r++) {
+        clock_gettime (CLOCK_MONOTONIC, &t0);
+        if ((semUp (semgid, PING) == -1) || (semDown (semgid, PONG) == -1)) {
+            kill (pid, SIGKILL);
+            waitpid (pid, NULL, 0);
+            return -1;
+        }
+        clock_gettime (CLOCK_MONOTONIC, &t1);
+        if (r >= WARMUP)
+            histRecord (h, ((t1.tv_sec - t0.tv_sec) * 1000000000UL + t1.tv_nsec - t0.tv_nsec) / 2);
+    }
+
+    if (waitpid (pid, &status, 0) == -1)
+        return -1;
+    return (WIFEXITED (status) && (WEXITSTATUS (status) == EXIT_SUCCESS)) ? 0 : -1;
+}
@@ -12,6 +12,31 @@
  *     \li checkPassport
  *     \li signalReadyToFlight
  *
+ *  Several hostesses may board the same flight in parallel (reduced-handshake protocol). Each one claims the next
+ *  passenger from the queue inside the critical region, and the one that checks the last passenger of the flight
+ *  closes the boarding and signals the pilot.
+ *
+ *  Parties of passengers are admitted atomically: the hostess boards all the members of the party at the head of the
+ *  queue at once, or, if the party does not fit in the plane, defers it to the next flight.
+ *
+ *  With the lock-free queue the passengers publish their ids in a multi-producer/single-consumer ring without taking
+ *  the mutex, and the hostess takes them in order of arrival.
+ *
+ *  With several destinations there is one queue per destination, and the hostess only boards the passengers queued
+ *  for the destination of the flight at the gate.
+ *
+ *  With priority classes the passengers in queue are kept in one queue per class, and the hostess takes the next one
+ *  from the highest class waiting, unless a passenger of a lower class was already overtaken too many times.
+ *
+ *  With mailboxes the hostess receives the opening of the boarding in her own mailbox, and tells each passenger the
+ *  check is over and the pilot the boarding is complete with messages.
+ *
+ *  With pipelined boarding the hostess pre-checks the passports of the passengers in queue while the plane is away,
+ *  keeping them in a holding area of up to MAXFC passengers, and boards them as soon as the next flight opens.
+ *
+ *  The life cycle is driven by a transition table (hostessMachine), whose states run the operations above; the
+ *  boarding variants of the run are chosen by the guards of the transitions.
+ *
  *  \author Nuno Lau - January 2022
  */
 
@@ -22,13 +47,24 @@
 #include <sys/types.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <sched.h>
 
 #include "probConst.h"
 #include "probDataStruct.h"
 #include "logging.h"
 #include "sharedDataSync.h"
 #include "semaphore.h"
+#include "mailbox.h"
+#include "fsm.h"
+#include "critRegion.h"
 #include "sharedMemory.h"
+#include "arrivals.h"
+#include "departure.h"
+#include "histogram.h"
+#include "boardingQueue.h"
+#include "mpscRing.h"
 
 /** \brief logging file name */
 static char nFic[51];
@@ -42,24 +78,153 @@ static int semgid;
 /** \brief pointer to shared memory region */
 static SHARED_DATA *sh;
 
+/** \brief hostess id */
+static unsigned int hostessId = 0;
+
+/** \brief instant the boarding of the present flight was opened to the hostess (<tt>CLOCK_MONOTONIC</tt>) */
+static struct timespec openedAt;
+
+/** \brief last flight whose boarding was opened to the hostess (pipelined boarding) */
+static unsigned int openedFlight = 0;
+
+/** \brief destination of the flight being boarded */
+static unsigned int dest = 0;
+
+/** \brief flight whose boarding the hostess is taking part in (several hostesses) */
+static unsigned int boardingFlight;
+
+/** \brief woken up at the end of the air lift, with no flight opened to the hostess */
+static bool released = false;
+
+/* Outcome of claiming a passenger (several hostesses) */
+
+/** \brief passenger checked, flight still boarding */
+#define CLAIM_NEXT   0
+/** \brief passenger checked, last one of the flight */
+#define CLAIM_LAST   1
+/** \brief no passenger left in queue, wait again */
+#define CLAIM_NONE   2
+/** \brief boarding was closed by another hostess */
+#define CLAIM_STALE  3
+
 /** \brief hostess waits for next flight */
 static void waitForNextFlight();
 
 /** \brief hostess waits for passenger */
-static void waitForPassenger();
+static bool waitForPassenger();
+
+/** \brief hostess boards the passengers pre-checked while the plane was away */
+static bool boardPreChecked();
 
 /** \brief hostess checks passport */
 static bool checkPassport();
 
+/** \brief hostess checks the passports of several passengers in queue */
+static bool checkPassportBatch();
+
+/** \brief hostess checks the passports of the party of passengers at the head of the queue */
+static bool checkPassportGroup();
+
+/** \brief hostess takes the next passenger from the queue */
+static unsigned int takePassenger(int cls);
+
+/** \brief the party at the head of the queue fits in the plane */
+static bool groupFits();
+
+/** \brief hostess boards a flight together with other hostesses */
+static void boardFlight();
+
+/** \brief hostess claims the next passenger in queue (several hostesses) */
+static int claimPassenger();
+
+/** \brief departure rule when the hold time of the flight being boarded expires */
+static bool holdExpired();
+
+/** \brief departure rule of the flight being boarded */
+static bool lastPassenger();
+
 /** \brief hostess signals boarding is complete */
 static void signalReadyToFlight();
 
-/** \brief getter for number of passengers flying */
+/** \brief getter for number of passengers on board of the plane at the gate */
 static int nPassengersInFlight();
 
 /** \brief getter for number of passengers waiting */
 static int nPassengersInQueue();
 
+/* estados do ciclo de vida da hospedeira */
+#define HT_START        0
+#define HT_WAIT_FLIGHT  1
+#define HT_BOARD_SHARED 2
+#define HT_PRECHECKED   3
+#define HT_WAIT_PASS    4
+#define HT_HOLD         5
+#define HT_CHECK        6
+#define HT_CHECK_BATCH  7
+#define HT_CHECK_GROUP  8
+#define HT_READY        9
+#define HT_END         10
+
+static int doStart(void *ctx);
+static int doWaitFlight(void *ctx);
+static int doBoardShared(void *ctx);
+static int doPreChecked(void *ctx);
+static int doWaitPassenger(void *ctx);
+static int doHold(void *ctx);
+static int doCheck(void *ctx);
+static int doCheckBatch(void *ctx);
+static int doCheckGroup(void *ctx);
+static int doReady(void *ctx);
+static bool working(void *ctx);
+static bool spare(void *ctx);
+static bool shared(void *ctx);
+static bool pipelined(void *ctx);
+static bool groups(void *ctx);
+static bool batch(void *ctx);
+
+/** \brief states of the life cycle of the hostess */
+static const FSM_STATE hostessStates[HT_END + 1] = {
+    [HT_START] = {"start", doStart},
+    [HT_WAIT_FLIGHT] = {"waitForNextFlight", doWaitFlight},
+    [HT_BOARD_SHARED] = {"boardFlight", doBoardShared},
+    [HT_PRECHECKED] = {"boardPreChecked", doPreChecked},
+    [HT_WAIT_PASS] = {"waitForPassenger", doWaitPassenger},
+    [HT_HOLD] = {"holdExpired", doHold},
+    [HT_CHECK] = {"checkPassport", doCheck},
+    [HT_CHECK_BATCH] = {"checkPassportBatch", doCheckBatch},
+    [HT_CHECK_GROUP] = {"checkPassportGroup", doCheckGroup},
+    [HT_READY] = {"signalReadyToFlight", doReady},
+    [HT_END] = {"end", NULL}};
+
+/** \brief transitions of the life cycle of the hostess */
+static const FSM_TRANSITION hostessTrans[] = {
+    {HT_START, FSM_ANY, working, HT_WAIT_FLIGHT}, // em modo de serviço a hospedeira trabalha até ser terminada
+    {HT_START, FSM_ANY, NULL, HT_END},
+    {HT_WAIT_FLIGHT, EV_DONE, spare, HT_END}, // acordada no fim do air lift por outra hospedeira
+    {HT_WAIT_FLIGHT, EV_DONE, shared, HT_BOARD_SHARED},
+    {HT_WAIT_FLIGHT, EV_DONE, pipelined, HT_PRECHECKED}, // primeiro os passageiros já pré-verificados
+    {HT_WAIT_FLIGHT, EV_DONE, NULL, HT_WAIT_PASS},
+    {HT_BOARD_SHARED, EV_DONE, NULL, HT_START},
+    {HT_PRECHECKED, EV_LAST, NULL, HT_READY},
+    {HT_PRECHECKED, EV_MORE, NULL, HT_WAIT_PASS},
+    {HT_WAIT_PASS, EV_TIMEOUT, NULL, HT_HOLD}, // o tempo máximo de espera do voo expirou
+    {HT_WAIT_PASS, EV_DONE, groups, HT_CHECK_GROUP}, // o grupo inteiro embarca ou fica para o voo seguinte
+    {HT_WAIT_PASS, EV_DONE, batch, HT_CHECK_BATCH}, // vários passageiros por acordar
+    {HT_WAIT_PASS, EV_DONE, NULL, HT_CHECK},
+    {HT_HOLD, EV_LAST, NULL, HT_READY},
+    {HT_HOLD, EV_MORE, NULL, HT_WAIT_PASS},
+    {HT_CHECK, EV_LAST, NULL, HT_READY},
+    {HT_CHECK, EV_MORE, NULL, HT_WAIT_PASS},
+    {HT_CHECK_BATCH, EV_LAST, NULL, HT_READY},
+    {HT_CHECK_BATCH, EV_MORE, NULL, HT_WAIT_PASS},
+    {HT_CHECK_GROUP, EV_LAST, NULL, HT_READY},
+    {HT_CHECK_GROUP, EV_MORE, NULL, HT_WAIT_PASS},
+    {HT_READY, EV_DONE, NULL, HT_START}};
+
+/** \brief life cycle of the hostess */
+static const FSM hostessMachine = {hostessStates, HT_END + 1, hostessTrans,
+                                   sizeof(hostessTrans) / sizeof(hostessTrans[0]), HT_START, HT_END};
+
 /**
  *  \brief Main program.
  *
@@ -73,7 +238,7 @@ int main(int argc, char *argv[])
 
     /* validation of command line parameters */
 
-    if (argc != 4)
+    if ((argc != 4) && (argc != 5))
     {
         freopen("error_HT", "a", stderr);
         fprintf(stderr, "Number of parameters is incorrect!\n");
@@ -89,6 +254,15 @@ int main(int argc, char *argv[])
         fprintf(stderr, "Error on the access key communication!\n");
         return EXIT_FAILURE;
     }
+    if (argc == 5) // identificação da hospedeira quando há várias
+    {
+        hostessId = (unsigned int)strtol(argv[4], &tinp, 0);
+        if ((*tinp != '\0') || (hostessId >= MAXHT))
+        {
+            fprintf(stderr, "Hostess process identification is wrong!\n");
+            return EXIT_FAILURE;
+        }
+    }
 
     /* connection to the semaphore set and the shared memory region and mapping the shared region onto the
        process address space */
@@ -108,24 +282,19 @@ int main(int argc, char *argv[])
         perror("error on mapping the shared region on the process address space");
         return EXIT_FAILURE;
     }
-
-    srandom((unsigned int)getpid()); /* initialize random generator */
+    semCount(&sh->semOps); // contabiliza as operações sobre semáforos no total da simulação
+    if (sh->fSt.par.eventFd)
+        semUseEvents(sh->eventFd); // as esperas passam a ser feitas nos eventfd herdados do lançador
+    mbCount(&sh->msgOps); // contabiliza as mensagens enviadas no total da simulação
+    if (sh->fSt.par.lockStats)
+        crProfile(&sh->crProf); // regista os tempos de espera e de posse do mutex de cada região crítica
 
     /* simulation of the life cycle of the hostess */
 
-    int nPassengers = 0;
-    bool lastPassengerInFlight;
-
-    while (nPassengers < N)
+    if ((fsmCheck(&hostessMachine) == -1) || (fsmRun(&hostessMachine, NULL) == -1))
     {
-        waitForNextFlight();
-        do
-        {
-            waitForPassenger();
-            lastPassengerInFlight = checkPassport();
-            nPassengers++;
-        } while (!lastPassengerInFlight);
-        signalReadyToFlight();
+        perror("error on the life cycle of the hostess");
+        return EXIT_FAILURE;
     }
 
     /* unmapping the shared region off the process address space */
@@ -140,39 +309,233 @@ int main(int argc, char *argv[])
     return EXIT_SUCCESS;
 }
 
+/**
+ *  \brief actions and guards of the life cycle of the hostess
+ *
+ *  Each action runs one operation of the hostess and returns the event that took place; the operations that check
+ *  passengers return EV_LAST once the flight must depart.
+ */
+
+static int doStart(void *ctx)
+{
+    return EV_DONE;
+}
+
+static int doWaitFlight(void *ctx)
+{
+    waitForNextFlight();
+    return EV_DONE;
+}
+
+static int doBoardShared(void *ctx)
+{
+    boardFlight();
+    return EV_DONE;
+}
+
+static int doPreChecked(void *ctx)
+{
+    return (boardPreChecked()) ? EV_LAST : EV_MORE;
+}
+
+static int doWaitPassenger(void *ctx)
+{
+    return (waitForPassenger()) ? EV_DONE : EV_TIMEOUT;
+}
+
+static int doHold(void *ctx)
+{
+    return (holdExpired()) ? EV_LAST : EV_MORE;
+}
+
+static int doCheck(void *ctx)
+{
+    return (checkPassport()) ? EV_LAST : EV_MORE;
+}
+
+static int doCheckBatch(void *ctx)
+{
+    return (checkPassportBatch()) ? EV_LAST : EV_MORE;
+}
+
+static int doCheckGroup(void *ctx)
+{
+    return (checkPassportGroup()) ? EV_LAST : EV_MORE;
+}
+
+static int doReady(void *ctx)
+{
+    signalReadyToFlight();
+    return EV_DONE;
+}
+
+static bool working(void *ctx)
+{
+    return sh->fSt.par.service || !sh->fSt.finished;
+}
+
+static bool spare(void *ctx)
+{
+    return released;
+}
+
+static bool shared(void *ctx)
+{
+    return sh->fSt.par.nHostess > 1;
+}
+
+static bool pipelined(void *ctx)
+{
+    return sh->fSt.par.preBoarding;
+}
+
+static bool groups(void *ctx)
+{
+    return sh->fSt.par.maxGroup > 1;
+}
+
+static bool batch(void *ctx)
+{
+    return sh->fSt.par.batch > 1;
+}
+
 /**
  *  \brief wait for Next Flight.
  *
  *  Hostess updates its state and waits for plane to be ready for boarding
  *  The internal state should be saved.
  *
+ *  With pipelined boarding, while the holding area is not full the hostess waits on passengersInQueue instead, which
+ *  the pilot rings with a spare unit when the plane is ready for boarding. Every other unit belongs to a passenger in
+ *  queue, whose passport is pre-checked. The internal state should be saved at each pre-check.
+ *
+ *  A hostess woken up at the end of the air lift is released only if no flight still boarding was opened to her:
+ *  a flight opened by the pilot before the end is always boarded.
  */
 
 static void waitForNextFlight()
 {   
-    /* enter critical region */
-    if (semDown(semgid, sh->mutex) == -1)
-    {                                                                          
-        perror("error on the down operation for semaphore access (HT)");
-        exit(EXIT_FAILURE);
+    unsigned int bell;    // semáforo em que a hospedeira espera
+    bool open = false;    // o embarque do voo seguinte já abriu
+
+    /* critical region, left at the end of the block */
+    {
+        CRITICAL_REGION(semgid, sh->mutex, "HT.waitForNextFlight.state");
+        sh->fSt.st.hostessStat[hostessId] = WAIT_FOR_FLIGHT; // muda o estado da hospedeira para WAIT_FOR_FLIGHT
+        saveState(nFic, &sh->fSt);                // regista a mudança do estado
+        // o piloto pode já ter aberto o voo seguinte (vários aviões); nesse caso espera por readyForBoarding
+        sh->doorbell = sh->fSt.par.preBoarding && (sh->nPreChecked < MAXFC) && (sh->fSt.nFlight == openedFlight);
+        bell = (sh->doorbell) ? sh->passengersInQueue[dest] : sh->readyForBoarding;
     }
 
-    sh->fSt.st.hostessStat = WAIT_FOR_FLIGHT; // muda o estado da hospedeira para WAIT_FOR_FLIGHT
-    saveState(nFic, &sh->fSt);                // regista a mudança do estado
+    while (!open)
+    {
+        // espera que o piloto sinalize que já pode começar o boarding (ou, em pipeline, por um passageiro)
+        if (sh->fSt.par.mailbox)
+        {
+            if (mbExpect(&sh->hostessBox, MSG_BOARDING_OPEN, NULL) == -1)
+            {
+                perror("error on receiving a message (HT)");
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (semDown(semgid, bell) == -1)
+        {
+            perror("error on the down operation for semaphore access (HT)");
+            exit(EXIT_FAILURE);
+        }
+        if (bell == sh->readyForBoarding)
+            open = true;
+        else // região crítica até ao fim do bloco
+        {
+            CRITICAL_REGION(semgid, sh->mutex, "HT.waitForNextFlight.preCheck");
+            if (sh->spare > 0) // unidade de reserva: o avião está pronto para o embarque
+            {
+                sh->spare--;
+                open = true;
+            }
+            else // unidade de um passageiro em fila: pré-verifica o passaporte
+            {
+                unsigned int passengerId = takePassenger(-1);
+
+                sh->preChecked[sh->nPreChecked++] = passengerId;
+                sh->fSt.passengerChecked = passengerId;
+                sh->fSt.st.hostessStat[hostessId] = CHECK_PASSPORT;
+                saveState(nFic, &sh->fSt);
+                savePassengerPreChecked(nFic, &sh->fSt);
+                sh->fSt.st.hostessStat[hostessId] = WAIT_FOR_FLIGHT;
+                saveState(nFic, &sh->fSt);
+            }
+            sh->doorbell = !open && (sh->nPreChecked < MAXFC);
+            if (!open && !sh->doorbell) // área de espera cheia: espera apenas pelo piloto
+                bell = sh->readyForBoarding;
+        }
+    }
 
-    /* exit critical region */
-    if (semUp(semgid, sh->mutex) == -1) 
+    /* critical region, left at the end of the block */
     {
-        perror("error on the up operation for semaphore access (HT)");
-        exit(EXIT_FAILURE);
+        CRITICAL_REGION(semgid, sh->mutex, "HT.waitForNextFlight.open");
+        // só termina se nenhum voo por embarcar lhe foi aberto; um voo aberto antes do fim embarca sempre
+        released = sh->fSt.finished && (!sh->boarding || (sh->fSt.nFlight == openedFlight));
+        openedFlight = sh->fSt.nFlight; // o piloto atualiza o voo antes de o sinalizar
+        dest = sh->fSt.plane[sh->fSt.atGate].dest;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &openedAt);
+}
+
+/**
+ *  \brief boarding of the passengers pre-checked while the plane was away (pipelined boarding)
+ *
+ *  Inside a single critical region the hostess boards the pre-checked passengers, in order, updating the counters
+ *  as in checkPassport and stopping as soon as the flight must depart; the rest stay for the next flight. The
+ *  boarded passengers are then released together.
+ *  The internal state is saved as in checkPassport for each passenger.
+ *
+ *  \return true if the last passenger boarded is the last passenger for this flight
+ */
+
+static bool boardPreChecked()
+{
+    bool last = false;
+    unsigned int n = 0, i;
+    unsigned int released[MAXFC]; // semáforos dos passageiros embarcados
+
+    /* critical region, left at the end of the block */
+    {
+        CRITICAL_REGION(semgid, sh->mutex, "HT.boardPreChecked.board");
+        while (!last && (n < sh->nPreChecked))
+        {
+            unsigned int passengerId = sh->preChecked[n];
+
+            sh->fSt.passengerChecked = passengerId;
+            sh->fSt.st.passengerStat[passengerId] = IN_FLIGHT;
+            sh->seat[passengerId] = sh->fSt.atGate;
+            saveState(nFic, &sh->fSt);
+
+            sh->fSt.nPassInQueue--;
+            sh->fSt.nPassInFlight++;
+            sh->onBoard[sh->fSt.atGate][nPassengersInFlight()] = sh->fSt.passengerChecked; // lista de embarcados do voo
+            sh->fSt.plane[sh->fSt.atGate].nPass++;
+            sh->fSt.totalPassBoarded++;
+            sh->fSt.route[dest].nBoarded++;
+            savePassengerChecked(nFic, &sh->fSt);
+            saveState(nFic, &sh->fSt);
+
+            released[n++] = sh->checkDone + passengerId;
+            last = lastPassenger();
+        }
+        for (i = n; i < sh->nPreChecked; i++) // os restantes ficam para o voo seguinte
+            sh->preChecked[i - n] = sh->preChecked[i];
+        sh->nPreChecked -= n;
     }
 
-    // espera que o piloto sinalize que já pode começar o boarding
-    if (semDown(semgid, sh->readyForBoarding) == -1)
+    if ((n > 0) && (semUpEach(semgid, released, n) == -1))
     {
-        perror("error on the down operation for semaphore access (HT)");
+        perror("error on the up operation for semaphore access (HT)");
         exit(EXIT_FAILURE);
-    } 
+    }
+
+    return last;
 }
 
 /**
@@ -180,33 +543,53 @@ static void waitForNextFlight()
  *
  *  hostess waits for passengers to arrive at airport.
  *  The internal state should be saved.
+ *
+ *  If the departure policy sets a max hold time and there are passengers on board, the hostess only waits until the
+ *  hold time of the flight expires.
+ *
+ *  \return false if there are several hostesses and the boarding of the flight is already closed, or if the hold
+ *     time expired
  */
 
-static void waitForPassenger()
+static bool waitForPassenger()
 {
-    /* enter critical region */
-    if (semDown(semgid, sh->mutex) == -1) 
-    {
-        perror("error on the down operation for semaphore access (HT)");
-        exit(EXIT_FAILURE);
-    }
+    double hold = departureHold(&sh->fSt.par.departure); // tempo máximo de espera do voo
+    struct timespec now;
 
-    sh->fSt.st.hostessStat = WAIT_FOR_PASSENGER; // muda o estado da hospedeira para WAIT_FOR_PASSENGER
-    saveState(nFic, &sh->fSt);                  // guarda o estado
+    /* critical region, left at the end of the block */
+    {
+        CRITICAL_REGION(semgid, sh->mutex, "HT.waitForPassenger.state");
+        // com várias hospedeiras, outra pode já ter fechado o embarque deste voo
+        if ((sh->fSt.par.nHostess > 1) && !sh->boarding)
+            return false; // o mutex é libertado ao sair do bloco
+        boardingFlight = sh->fSt.nFlight;
+        if (nPassengersInFlight() == 0) // um avião vazio espera sempre pelo primeiro passageiro
+            hold = 0.0;
 
-    /* exit critical region */
-    if (semUp(semgid, sh->mutex) == -1)
-    { 
-        perror("error on the up operation for semaphore access (HT)");
-        exit(EXIT_FAILURE);
+        sh->fSt.st.hostessStat[hostessId] = WAIT_FOR_PASSENGER; // muda o estado da hospedeira para WAIT_FOR_PASSENGER
+        saveState(nFic, &sh->fSt);                  // guarda o estado
     }
 
     // Espera que os passageiros chegam à fila de espera
-    if (semDown(semgid, sh->passengersInQueue) == -1)
+    if (hold > 0.0)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        hold -= (now.tv_sec - openedAt.tv_sec) + (now.tv_nsec - openedAt.tv_nsec) / 1e9;
+        if (semDownTimed(semgid, sh->passengersInQueue[dest], hold) == -1)
+        {
+            if (errno == EAGAIN)
+                return false;
+            perror("error on the down operation for semaphore access (HT)");
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (semDown(semgid, sh->passengersInQueue[dest]) == -1)
     {
         perror("error on the down operation for semaphore access (HT)");
         exit(EXIT_FAILURE);
     }
+
+    return true;
 }
 
 /**
@@ -220,89 +603,436 @@ static void waitForPassenger()
  *      - flight is at its maximum capacity
  *      - flight is at or higher than minimum capacity and no passenger waiting
  *      - no more passengers
+ *
+ *  With the reduced-handshake protocol the hostess takes the passenger id from the queue, updates the passenger
+ *  state on its behalf and wakes it up once, in a single critical region.
  */
 
 static bool checkPassport()
 {
     bool last;
+    unsigned int passengerId = 0;
+
+    if (!sh->fSt.par.fastBoarding)
+    {
+        // atende um passageiro
+        if (semUp(semgid, sh->passengersWaitInQueue) == -1)
+        {
+            perror("error on the up operation for semaphore access (HT)");
+            exit(EXIT_FAILURE);
+        }
 
-    // atende um passageiro
-    if (semUp(semgid, sh->passengersWaitInQueue) == -1)
+        /* critical region, left at the end of the block */
+        {
+            CRITICAL_REGION(semgid, sh->mutex, "HT.checkPassport.state");
+            sh->fSt.st.hostessStat[hostessId] = CHECK_PASSPORT; // atualiza o estado da hospedeira para CHECK_PASSAPORT
+            saveState(nFic, &sh->fSt);               // guarda o estado
+        }
+
+        // espera que o passageiro forneça o ID
+        if (semDown(semgid, sh->idShown) == -1)
+        {
+            perror("error on the down operation for semaphore access (HT)");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    /* critical region, left at the end of the block */
+    {
+        CRITICAL_REGION(semgid, sh->mutex, "HT.checkPassport.count");
+        if (sh->fSt.par.fastBoarding)
+        {
+            sh->fSt.st.hostessStat[hostessId] = CHECK_PASSPORT;            // atualiza o estado da hospedeira para CHECK_PASSAPORT
+            saveState(nFic, &sh->fSt);
+            passengerId = takePassenger(-1);                    // o passageiro seguinte na fila
+            sh->fSt.passengerChecked = passengerId;             // o id fornecido pelo passageiro
+            sh->fSt.st.passengerStat[passengerId] = IN_FLIGHT;  // entra no aviao
+            sh->seat[passengerId] = sh->fSt.atGate;             // no avião que está na porta
+            saveState(nFic, &sh->fSt);
+        }
+
+        sh->fSt.nPassInQueue--;               // decrementa a fila de espera
+        sh->fSt.nPassInFlight++;              // incrementa a lotação no avião
+        sh->onBoard[sh->fSt.atGate][nPassengersInFlight()] = sh->fSt.passengerChecked; // lista de embarcados do voo
+        sh->fSt.plane[sh->fSt.atGate].nPass++;
+        sh->fSt.totalPassBoarded++;           // incrementa o registo de já embarcados no total
+        sh->fSt.route[dest].nBoarded++;
+        savePassengerChecked(nFic, &sh->fSt); // imprime a mensagem de que o passageiro deu checked-in
+        saveState(nFic, &sh->fSt);            // guarda os valores dos contadores
+
+        // Verifica se o avião está pronto para partir
+        last = lastPassenger();
+    }
+
+    // caixas de correio: uma mensagem ao passageiro conclui o check-in
+    if (sh->fSt.par.mailbox)
+    {
+        if (mbSend(&sh->passengerBox[passengerId], MSG_CHECK_DONE, sh->seat[passengerId]) == -1)
+        {
+            perror("error on sending a message (HT)");
+            exit(EXIT_FAILURE);
+        }
+    }
+    // protocolo reduzido: um único acordar do passageiro conclui o check-in
+    else if (sh->fSt.par.fastBoarding && (semUp(semgid, sh->checkDone + passengerId) == -1))
     {
         perror("error on the up operation for semaphore access (HT)");
         exit(EXIT_FAILURE);
     }
 
-    /* enter critical region */
-    if (semDown(semgid, sh->mutex) == -1)
-    {                                                                       
+    return last;
+}
+
+/**
+ *  \brief batch passport check
+ *
+ *  The hostess takes up to <tt>batch</tt> passengers from the queue (reduced-handshake protocol) in a single
+ *  critical region, checking them one by one as in checkPassport and stopping as soon as the flight must depart.
+ *  The extra passengers are claimed from passengersInQueue in one operation and all the checked passengers are
+ *  released together.
+ *  The internal state is saved as in checkPassport for each passenger.
+ *
+ *  \return should be true if the last passenger checked is the last passenger for this flight
+ */
+
+static bool checkPassportBatch()
+{
+    bool last;
+    unsigned int n = 0;
+    unsigned int released[MAXFC]; // semáforos dos passageiros verificados
+
+    /* critical region, left at the end of the block */
+    {
+        CRITICAL_REGION(semgid, sh->mutex, "HT.checkPassportBatch.count");
+        sh->fSt.st.hostessStat[hostessId] = CHECK_PASSPORT; // atualiza o estado da hospedeira para CHECK_PASSAPORT
+        saveState(nFic, &sh->fSt);
+
+        // o primeiro passageiro já foi assinalado em waitForPassenger; os seguintes estão na fila
+        do
+        {
+            unsigned int passengerId = takePassenger(-1);
+
+            sh->fSt.passengerChecked = passengerId;
+            sh->fSt.st.passengerStat[passengerId] = IN_FLIGHT;
+            sh->seat[passengerId] = sh->fSt.atGate;
+            saveState(nFic, &sh->fSt);
+
+            sh->fSt.nPassInQueue--;
+            sh->fSt.nPassInFlight++;
+            sh->onBoard[sh->fSt.atGate][nPassengersInFlight()] = sh->fSt.passengerChecked; // lista de embarcados do voo
+            sh->fSt.plane[sh->fSt.atGate].nPass++;
+            sh->fSt.totalPassBoarded++;
+            sh->fSt.route[dest].nBoarded++;
+            savePassengerChecked(nFic, &sh->fSt);
+            saveState(nFic, &sh->fSt);
+
+            released[n++] = sh->checkDone + passengerId;
+            last = lastPassenger();
+        } while (!last && (n < sh->fSt.par.batch) && (nPassengersInQueue() > 0));
+    }
+
+    // os passageiros extra deixam de contar como à espera de atendimento
+    if ((n > 1) && (semDownMany(semgid, sh->passengersInQueue[dest], n - 1) == -1))
+    {
         perror("error on the down operation for semaphore access (HT)");
         exit(EXIT_FAILURE);
     }
 
+    // liberta todos os passageiros verificados de uma só vez
+    if (semUpEach(semgid, released, n) == -1)
+    {
+        perror("error on the up operation for semaphore access (HT)");
+        exit(EXIT_FAILURE);
+    }
+
+    return last;
+}
+
+/**
+ *  \brief party passport check
+ *
+ *  Inside a single critical region the hostess checks, as in checkPassport, all the members of the party at the head
+ *  of the queue (reduced-handshake protocol), who were queued together. The extra members are claimed from
+ *  passengersInQueue in one operation and all of them are released together. If the party does not fit in the plane
+ *  it is deferred: nobody is checked, the unit of passengersInQueue is given back and the flight departs.
+ *  The internal state is saved as in checkPassport for each passenger.
+ *
+ *  \return should be true if this is the last party for this flight, that is, if the departure rule holds or the
+ *     next party in queue does not fit in the plane
+ */
+
+static bool checkPassportGroup()
+{
+    bool last;
+    unsigned int n = 0, g;
+    int c;                        // classe do grupo à cabeça da fila
+    unsigned int released[MAXFC]; // semáforos dos membros do grupo
+
+    /* critical region, left at the end of the block */
+    {
+        CRITICAL_REGION(semgid, sh->mutex, "HT.checkPassportGroup.count");
+        sh->fSt.st.hostessStat[hostessId] = CHECK_PASSPORT; // atualiza o estado da hospedeira para CHECK_PASSAPORT
+        saveState(nFic, &sh->fSt);
 
-    sh->fSt.st.hostessStat = CHECK_PASSPORT; // atualiza o estado da hospedeira para CHECK_PASSAPORT
-    saveState(nFic, &sh->fSt);               // guarda o estado
+        if (!groupFits()) // o grupo não cabe no avião: fica para o voo seguinte
+        {
+            last = true;
+        }
+        else
+        {
+            c = bqNext(&sh->queue[dest], sh->fSt.par.classes.bound); // os membros estão seguidos na fila da sua classe
+            g = sh->group[bqPeek(&sh->queue[dest], c)];
+            while (n < sh->groupSize[g])
+            {
+                unsigned int passengerId = takePassenger(c);
 
-    /* exit critical region */
-    if (semUp(semgid, sh->mutex) == -1)
-    {                                                                      
+                sh->fSt.passengerChecked = passengerId;
+                sh->fSt.st.passengerStat[passengerId] = IN_FLIGHT;
+                sh->seat[passengerId] = sh->fSt.atGate;
+                saveState(nFic, &sh->fSt);
+
+                sh->fSt.nPassInQueue--;
+                sh->fSt.nPassInFlight++;
+                sh->onBoard[sh->fSt.atGate][nPassengersInFlight()] = sh->fSt.passengerChecked; // lista de embarcados do voo
+                sh->fSt.plane[sh->fSt.atGate].nPass++;
+                sh->fSt.totalPassBoarded++;
+                sh->fSt.route[dest].nBoarded++;
+                savePassengerChecked(nFic, &sh->fSt);
+                saveState(nFic, &sh->fSt);
+
+                released[n++] = sh->checkDone + passengerId;
+            }
+            last = lastPassenger() || !groupFits();
+        }
+    }
+
+    // grupo adiado: a unidade pertence a um passageiro que continua na fila
+    if ((n == 0) && (semUp(semgid, sh->passengersInQueue[dest]) == -1))
+    {
         perror("error on the up operation for semaphore access (HT)");
         exit(EXIT_FAILURE);
     }
-
-    // espera que o passageiro forneça o ID
-    if (semDown(semgid, sh->idShown) == -1)
+    // os restantes membros deixam de contar como à espera de atendimento
+    if ((n > 1) && (semDownMany(semgid, sh->passengersInQueue[dest], n - 1) == -1))
     {
         perror("error on the down operation for semaphore access (HT)");
         exit(EXIT_FAILURE);
     }
-    /* enter critical region */
-    if (semDown(semgid, sh->mutex) == -1)
-    {                                                                       
-        perror("error on the down operation for semaphore access (HT)");
+    if ((n > 0) && (semUpEach(semgid, released, n) == -1))
+    {
+        perror("error on the up operation for semaphore access (HT)");
         exit(EXIT_FAILURE);
     }
 
-    sh->fSt.nPassInQueue--;               // decrementa a fila de espera
-    sh->fSt.nPassInFlight++;              // incrementa a lotação no avião
-    sh->fSt.totalPassBoarded++;           // incrementa o registo de já embarcados no total
-    savePassengerChecked(nFic, &sh->fSt); // imprime a mensagem de que o passageiro deu checked-in
-    saveState(nFic, &sh->fSt);            // guarda os valores dos contadores
+    return last;
+}
+
+/**
+ *  \brief retrieval of the next passenger from the queue (reduced-handshake protocol)
+ *
+ *  The hostess takes the head of the given priority class, or of the class to be served next, and records the time
+ *  the passenger waited in queue. Must be called inside the critical region.
+ *  With the lock-free queue the id is taken from the ring instead. A unit of passengersInQueue is only given after
+ *  the id is published, but the id at the head may belong to a passenger still publishing it, so the hostess yields
+ *  until it is.
+ *
+ *  \param cls priority class, or -1 for the class to be served next
+ *
+ *  \return passenger id
+ */
+
+static unsigned int takePassenger(int cls)
+{
+    unsigned int passengerId;
 
-    // Verifica se o avião está pronto para partir
-    if (nPassengersInFlight() == MAXFC)     // se a lotação do avião chegou ao seu máximo
+    if (sh->fSt.par.lockFree) // fila sem bloqueio: o passageiro pode ainda estar a publicar o id
     {
-        last = true;
-    }
-    else if (nPassengersInFlight() >= MINFC && nPassengersInQueue() == 0){      // já há numero minimo de lotação e ninguem na fila de espera
-        last = true;
-    }
-    else if (sh->fSt.totalPassBoarded == N){                // já todos os passageiros embarcaram 
-        last = true;
+        while (mpscPop(&sh->ring, &passengerId) == -1)
+            sched_yield();
+        histRecord(&sh->queueWait[CLASS_GENERAL], elapsedSince(&sh->start) - sh->queued[passengerId]);
+        return passengerId;
     }
-    else
+    if (cls == -1)
+        cls = bqNext(&sh->queue[dest], sh->fSt.par.classes.bound);
+    passengerId = bqPop(&sh->queue[dest], cls);
+    histRecord(&sh->queueWait[cls], elapsedSince(&sh->start) - sh->queued[passengerId]);
+
+    return passengerId;
+}
+
+/**
+ *  \brief test if the party at the head of the queue fits in the plane
+ *
+ *  Must be called inside the critical region.
+ *
+ *  \return true if the queue is empty or the party at its head fits in the seats left
+ */
+
+static bool groupFits()
+{
+    int c = bqNext(&sh->queue[dest], sh->fSt.par.classes.bound); // classe servida a seguir
+
+    if (c == -1)
+        return true;
+    return nPassengersInFlight() + sh->groupSize[sh->group[bqPeek(&sh->queue[dest], c)]] <= MAXFC;
+}
+
+/**
+ *  \brief boarding of a flight by several hostesses
+ *
+ *  The hostess keeps claiming passengers until she checks the last one of the flight, in which case she signals the
+ *  pilot, or until another hostess closes the boarding.
+ */
+
+static void boardFlight()
+{
+    int claim;
+
+    do
     {
-        last = false;
+        if (!waitForPassenger())
+            return;
+        claim = claimPassenger();
+    } while ((claim == CLAIM_NEXT) || (claim == CLAIM_NONE));
+
+    if (claim == CLAIM_LAST)
+        signalReadyToFlight();
+}
+
+/**
+ *  \brief claim of the next passenger in queue (several hostesses)
+ *
+ *  Called after a unit of passengersInQueue is taken. Inside a single critical region the hostess checks that the
+ *  boarding she joined is still open, takes the next passenger id from the queue and checks the passport as in
+ *  checkPassport. If the passenger is the last one of the flight she closes the boarding and wakes up, with spare
+ *  units of passengersInQueue, the hostesses still waiting for a passenger.
+ *  A unit taken after the boarding closed, or when the queue is empty, is a spare one (or belongs to a passenger
+ *  that stays in queue and is given back).
+ *  The internal state should be saved as in checkPassport.
+ *
+ *  \return CLAIM_NEXT, CLAIM_LAST, CLAIM_NONE or CLAIM_STALE
+ */
+
+static int claimPassenger()
+{
+    int claim;
+    unsigned int passengerId = 0, h;
+    unsigned int nWaiting = 0; // hospedeiras ainda à espera de passageiro quando o embarque fecha
+    bool giveBack = false;
+
+    /* critical region, left at the end of the block */
+    {
+        CRITICAL_REGION(semgid, sh->mutex, "HT.claimPassenger.claim");
+        if (!sh->boarding || (sh->fSt.nFlight != boardingFlight)) // o embarque já fechou
+        {
+            if (sh->spare > 0)
+                sh->spare--;
+            else
+                giveBack = true; // a unidade pertence a um passageiro que continua na fila
+            claim = CLAIM_STALE;
+        }
+        else if (bqEmpty(&sh->queue[dest])) // unidade de reserva, ninguém na fila
+        {
+            sh->spare--;
+            claim = CLAIM_NONE;
+        }
+        else
+        {
+            sh->fSt.st.hostessStat[hostessId] = CHECK_PASSPORT; // atualiza o estado da hospedeira para CHECK_PASSAPORT
+            saveState(nFic, &sh->fSt);
+            passengerId = takePassenger(-1);                      // reclama o passageiro seguinte na fila
+            sh->fSt.passengerChecked = passengerId;
+            sh->fSt.st.passengerStat[passengerId] = IN_FLIGHT;
+            sh->seat[passengerId] = sh->fSt.atGate;
+            saveState(nFic, &sh->fSt);
+
+            sh->fSt.nPassInQueue--;
+            sh->fSt.nPassInFlight++;
+            sh->onBoard[sh->fSt.atGate][nPassengersInFlight()] = sh->fSt.passengerChecked; // lista de embarcados do voo
+            sh->fSt.plane[sh->fSt.atGate].nPass++;
+            sh->fSt.totalPassBoarded++;
+            sh->fSt.route[dest].nBoarded++;
+            savePassengerChecked(nFic, &sh->fSt);
+            saveState(nFic, &sh->fSt);
+
+            claim = CLAIM_NEXT;
+            if (lastPassenger()) // só uma hospedeira fecha o embarque de cada voo
+            {
+                sh->boarding = false;
+                for (h = 0; h < sh->fSt.par.nHostess; h++)
+                    if ((h != hostessId) && (sh->fSt.st.hostessStat[h] == WAIT_FOR_PASSENGER))
+                        nWaiting++;
+                sh->spare += nWaiting;
+                claim = CLAIM_LAST;
+            }
+        }
     }
 
-    /* exit critical region */
-    if (semUp(semgid, sh->mutex) == -1)
-    { 
+    if (((claim == CLAIM_NEXT) || (claim == CLAIM_LAST)) && (semUp(semgid, sh->checkDone + passengerId) == -1))
+    {
         perror("error on the up operation for semaphore access (HT)");
         exit(EXIT_FAILURE);
     }
+    if ((giveBack && (semUp(semgid, sh->passengersInQueue[dest]) == -1)) ||
+        ((nWaiting > 0) && (semUpMany(semgid, sh->passengersInQueue[dest], nWaiting) == -1)))
+    {
+        perror("error on the up operation for semaphore access (HT)");
+        exit(EXIT_FAILURE);
+    }
+
+    return claim;
+}
+
+/**
+ *  \brief departure rule when the hold time of the flight being boarded expires
+ *
+ *  \return true if the flight must depart with the passengers already on board
+ */
+
+static bool holdExpired()
+{
+    bool last;
+
+    /* critical region, left at the end of the block */
+    {
+        CRITICAL_REGION(semgid, sh->mutex, "HT.holdExpired.rule");
+        last = departureOnHold(nPassengersInFlight(), nPassengersInQueue());
+    }
 
     return last;
 }
 
+/**
+ *  \brief departure rule of the flight being boarded
+ *
+ *  Must be called inside the critical region, after a passenger is checked.
+ *
+ *  \return true if this is the last passenger for this flight, according to the departure policy of the run (by
+ *     default:
+ *      - flight is at its maximum capacity
+ *      - flight is at or higher than minimum capacity and no passenger waiting
+ *      - no more passengers)
+ */
+
+static bool lastPassenger()
+{
+    // já embarcaram todos os passageiros para o destino do voo (modo de serviço: o serviço terminou, ou estão todos
+    // a bordo, num destino com menos passageiros do que a lotação mínima)
+    bool noMore = (sh->fSt.par.service) ? (sh->fSt.finished || (nPassengersInFlight() >= sh->fSt.route[dest].nPass))
+                                        : (sh->fSt.route[dest].nBoarded == sh->fSt.route[dest].nPass);
+
+    return departureDue(&sh->fSt.par.departure, nPassengersInFlight(), nPassengersInQueue(), noMore);
+}
+
 static int nPassengersInFlight()
 {
-    return sh->fSt.nPassInFlight;
+    return sh->fSt.plane[sh->fSt.atGate].nPass;
 }
 
 static int nPassengersInQueue()
 {
+    if (sh->fSt.par.nDest > 1) // apenas os que esperam pelo destino do voo
+        return bqLength(&sh->queue[dest]);
     return sh->fSt.nPassInQueue;
 }
 
@@ -317,35 +1047,49 @@ static int nPassengersInQueue()
  */
 void signalReadyToFlight()
 {   
-    /* enter critical region */
-    if (semDown(semgid, sh->mutex) == -1)
-    { 
-        perror("error on the down operation for semaphore access (HT)");
-        exit(EXIT_FAILURE);
-    }
+    unsigned int onBoard; // passageiros a bordo do voo
+
+    /* critical region, left at the end of the block */
+    {
+        CRITICAL_REGION(semgid, sh->mutex, "HT.signalReadyToFlight.depart");
+        sh->fSt.st.hostessStat[hostessId] = READY_TO_FLIGHT; // atualiza o estado da hospedeira para READY_TO_FLIGHT
+        saveState(nFic, &sh->fSt); // atualiza os dados
 
-    sh->fSt.st.hostessStat = READY_TO_FLIGHT; // atualiza o estado da hospedeira para READY_TO_FLIGHT
-    saveState(nFic, &sh->fSt); // atualiza os dados
+        sh->fSt.nPassengersInFlight[(sh->fSt.nFlight - 1) % MAXNF] = nPassengersInFlight();      // regista o número de passageiros que o avião nFlight leva.
+        onBoard = nPassengersInFlight();
+        saveFlightDeparted(nFic, &sh->fSt);         // emite o anúncio que o voo descolou
 
-    sh->fSt.nPassengersInFlight[sh->fSt.nFlight - 1] = sh->fSt.nPassInFlight;      // regista o número de passageiros que o avião nFlight leva.
-    saveFlightDeparted(nFic, &sh->fSt);         // emite o anúncio que o voo descolou
+        // regista a espera dos passageiros deste voo, desde a entrada na fila até à partida
+        unsigned long now = elapsedSince(&sh->start);
+        for (unsigned int i = 0; i < onBoard; i++)
+            histRecord(&sh->wait, now - sh->queued[sh->onBoard[sh->fSt.atGate][i]]);
 
-    // avalia se este será o último voo necessário
-    if (sh->fSt.totalPassBoarded == N)
+        // avalia se este será o último voo necessário
+        if (!sh->fSt.par.service && sh->fSt.totalPassBoarded == N)
+        {
+            sh->fSt.finished = true;
+        }
+    }
+    
+    // sinaliza ao piloto que já está pronto para voar (caixas de correio: com uma mensagem)
+    if (sh->fSt.par.mailbox)
     {
-        sh->fSt.finished = true;
+        if (mbSend(&sh->pilotBox[sh->fSt.atGate], MSG_BOARDING_DONE, onBoard) == -1)
+        {
+            perror("error on sending a message (HT)");
+            exit(EXIT_FAILURE);
+        }
     }
-
-    /* exit critical region */
-    if (semUp(semgid, sh->mutex) == -1)
-    { 
+    else if (semUp(semgid, sh->readyToFlight[sh->fSt.atGate]))
+    {                       
         perror("error on the up operation for semaphore access (HT)");
         exit(EXIT_FAILURE);
     }
-    
-    // sinaliza ao piloto que já está pronto para voar
-    if (semUp(semgid, sh->readyToFlight))
-    {                       
+
+    // no fim do air lift acorda as outras hospedeiras que esperam pelo voo seguinte
+    if (sh->fSt.finished && (sh->fSt.par.nHostess > 1) &&
+        (semUpMany(semgid, sh->readyForBoarding, sh->fSt.par.nHostess - 1) == -1))
+    {
         perror("error on the up operation for semaphore access (HT)");
         exit(EXIT_FAILURE);
     }
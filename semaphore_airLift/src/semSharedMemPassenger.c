@@ -11,6 +11,15 @@
  *     \li waitInQueue
  *     \li waitUntilDestination
  *
+ *  A passenger process may also act as a worker that hosts a contiguous range of passengers, one thread each
+ *  (M:N model). The protocol with the hostess and the pilot is the same in both cases.
+ *
+ *  With mailboxes the passenger receives the end of the passport check and the arrival of the flight in its own
+ *  mailbox, and the last one to leave the plane tells the pilot with a message.
+ *
+ *  The life cycle is driven by a transition table (passengerMachine), whose states run the operations above; the
+ *  same table drives a passenger process and a passenger thread of a worker.
+ *
  *  \author Nuno Lau - January 2022
  */
 
@@ -21,13 +30,21 @@
 #include <sys/types.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
 
 #include "probConst.h"
 #include "probDataStruct.h"
 #include "logging.h"
 #include "sharedDataSync.h"
 #include "semaphore.h"
+#include "mailbox.h"
+#include "fsm.h"
+#include "critRegion.h"
 #include "sharedMemory.h"
+#include "prng.h"
+#include "arrivals.h"
+#include "boardingQueue.h"
+#include "mpscRing.h"
 
 /** \brief logging file name */
 static char nFic[51];
@@ -41,11 +58,62 @@ static int semgid;
 /** \brief pointer to shared memory region */
 static SHARED_DATA *sh;
 
-static bool travelToAirport();
+/** \brief stack size of the passenger threads in worker mode */
+#define PASSENGER_STACK (64 * 1024)
+
+static void *passengerLife(void *arg);
+static bool travelToAirport(unsigned int passengerId);
+static void returnToAirport(unsigned int passengerId, PRNG *rng);
 static void waitInQueue(unsigned int passengerId);
 static void waitUntilDestination(unsigned int passengerId);
 static void leavePlane(unsigned int passengerId);
 
+/** \brief context of the life cycle of a passenger */
+typedef struct
+{
+    unsigned int id; /* id do passageiro */
+    PRNG rng;        /* gerador do passageiro, derivado da semente global */
+} PASSENGER_CTX;
+
+/* estados do ciclo de vida do passageiro */
+#define PG_START        0
+#define PG_TRAVEL       1
+#define PG_QUEUE        2
+#define PG_FLIGHT       3
+#define PG_RETURN       4
+#define PG_END          5
+
+static int doStart(void *ctx);
+static int doTravel(void *ctx);
+static int doQueue(void *ctx);
+static int doFlight(void *ctx);
+static int doReturn(void *ctx);
+static bool spawnedAtAirport(void *ctx);
+static bool travelsAgain(void *ctx);
+
+/** \brief states of the life cycle of the passenger */
+static const FSM_STATE passengerStates[PG_END + 1] = {
+    [PG_START] = {"start", doStart},
+    [PG_TRAVEL] = {"travelToAirport", doTravel},
+    [PG_QUEUE] = {"waitInQueue", doQueue},
+    [PG_FLIGHT] = {"waitUntilDestination", doFlight},
+    [PG_RETURN] = {"returnToAirport", doReturn},
+    [PG_END] = {"end", NULL}};
+
+/** \brief transitions of the life cycle of the passenger */
+static const FSM_TRANSITION passengerTrans[] = {
+    {PG_START, FSM_ANY, spawnedAtAirport, PG_QUEUE}, // em modo JIT o lançador só cria o passageiro quando este chega
+    {PG_START, FSM_ANY, NULL, PG_TRAVEL},
+    {PG_TRAVEL, EV_DONE, NULL, PG_QUEUE},
+    {PG_QUEUE, EV_DONE, NULL, PG_FLIGHT},
+    {PG_FLIGHT, EV_DONE, travelsAgain, PG_RETURN}, // modo de serviço: volta ao aeroporto e entra de novo na fila
+    {PG_FLIGHT, EV_DONE, NULL, PG_END},
+    {PG_RETURN, EV_DONE, NULL, PG_QUEUE}};
+
+/** \brief life cycle of the passenger */
+static const FSM passengerMachine = {passengerStates, PG_END + 1, passengerTrans,
+                                     sizeof(passengerTrans) / sizeof(passengerTrans[0]), PG_START, PG_END};
+
 /**
  *  \brief Main program.
  *
@@ -56,7 +124,7 @@ int main(int argc, char *argv[])
 {
     int key;    /*access key to shared memory and semaphore set */
     char *tinp; /* numerical parameters test flag */
-    int n;
+    int n, last; /* first and last passenger hosted by this process */
 
     /* validation of command line parameters */
 
@@ -69,8 +137,10 @@ int main(int argc, char *argv[])
     else
         freopen(argv[4], "w", stderr);
 
-    n = (unsigned int)strtol(argv[1], &tinp, 0);
-    if ((*tinp != '\0') || (n >= N))
+    n = last = (unsigned int)strtol(argv[1], &tinp, 0);
+    if (*tinp == '-') // intervalo "primeiro-último": processo trabalhador com vários passageiros
+        last = (unsigned int)strtol(tinp + 1, &tinp, 0);
+    if ((*tinp != '\0') || (n > last) || (last >= N))
     {
         fprintf(stderr, "Passenger process identification is wrong!\n");
         return EXIT_FAILURE;
@@ -101,14 +171,47 @@ int main(int argc, char *argv[])
         perror("error on mapping the shared region on the process address space");
         return EXIT_FAILURE;
     }
-
-    srandom((unsigned int)getpid()); /* initialize random generator */
+    semCount(&sh->semOps); // contabiliza as operações sobre semáforos no total da simulação
+    if (sh->fSt.par.eventFd)
+        semUseEvents(sh->eventFd); // as esperas passam a ser feitas nos eventfd herdados do lançador
+    mbCount(&sh->msgOps); // contabiliza as mensagens enviadas no total da simulação
+    if (sh->fSt.par.lockStats)
+        crProfile(&sh->crProf); // regista os tempos de espera e de posse do mutex de cada região crítica
 
     /* simulation of the life cycle of the passenger */
 
-    travelToAirport();
-    waitInQueue(n);
-    waitUntilDestination(n);
+    if (fsmCheck(&passengerMachine) == -1)
+    {
+        perror("error on the life cycle of the passenger");
+        return EXIT_FAILURE;
+    }
+    if (n == last)
+        passengerLife(&n);
+    else
+    {
+        int nThr = last - n + 1;
+        pthread_t thr[nThr];
+        unsigned int id[nThr];
+        pthread_attr_t attr;
+
+        pthread_attr_init(&attr);
+        pthread_attr_setstacksize(&attr, PASSENGER_STACK); // cada passageiro só precisa de uma pilha pequena
+        for (int t = 0; t < nThr; t++)
+        {
+            id[t] = n + t;
+            int rc = pthread_create(&thr[t], &attr, passengerLife, &id[t]); // devolve o código do erro, sem errno
+            if (rc != 0)
+            {
+                fprintf(stderr, "error on creating a passenger thread: %s\n", strerror(rc));
+                return EXIT_FAILURE;
+            }
+        }
+        for (int t = 0; t < nThr; t++)
+        {
+            pthread_join(thr[t], NULL);
+        }
+        pthread_attr_destroy(&attr);
+    }
 
     /* unmapping the shared region off the process address space */
 
@@ -122,19 +225,119 @@ int main(int argc, char *argv[])
     return EXIT_SUCCESS;
 }
 
+/**
+ *  \brief life cycle of one passenger
+ *
+ *  Runs in the main thread of a single passenger process or in one of the threads of a worker process.
+ *
+ *  \param arg pointer to the passenger id
+ */
+
+static void *passengerLife(void *arg)
+{
+    PASSENGER_CTX ctx;
+
+    ctx.id = *(unsigned int *)arg;
+    prngInit(&ctx.rng, prngSeed(sh->fSt.par.seed, SEED_PASSENGER, ctx.id));
+    if (fsmRun(&passengerMachine, &ctx) == -1)
+    {
+        perror("error on the life cycle of the passenger");
+        exit(EXIT_FAILURE);
+    }
+
+    return NULL;
+}
+
+/**
+ *  \brief actions and guards of the life cycle of the passenger
+ *
+ *  Each action runs one operation of the passenger of the context and returns the event that took place.
+ */
+
+static int doStart(void *ctx)
+{
+    return EV_DONE;
+}
+
+static int doTravel(void *ctx)
+{
+    travelToAirport(((PASSENGER_CTX *)ctx)->id);
+    return EV_DONE;
+}
+
+static int doQueue(void *ctx)
+{
+    waitInQueue(((PASSENGER_CTX *)ctx)->id);
+    return EV_DONE;
+}
+
+static int doFlight(void *ctx)
+{
+    waitUntilDestination(((PASSENGER_CTX *)ctx)->id);
+    return EV_DONE;
+}
+
+static int doReturn(void *ctx)
+{
+    returnToAirport(((PASSENGER_CTX *)ctx)->id, &((PASSENGER_CTX *)ctx)->rng);
+    return EV_DONE;
+}
+
+static bool spawnedAtAirport(void *ctx)
+{
+    return sh->fSt.par.jitSpawn;
+}
+
+static bool travelsAgain(void *ctx)
+{
+    // em modo de serviço continua até ser terminado: é o piloto que decide o fim do serviço
+    return sh->fSt.par.service;
+}
+
 /**
  *  \brief passenger goes to airport
  *
- *  The passenger takes a random time to reach the airport
+ *  The passenger reaches the airport at the arrival time drawn by the launcher (open-loop arrival process)
+ *
+ *  \param passengerId passenger id
  */
 
-static bool travelToAirport()
+static bool travelToAirport(unsigned int passengerId)
 {
-    usleep((unsigned int)floor((MAXTRAVEL * random()) / RAND_MAX + 1000));
+    struct timespec at; /* instante absoluto de chegada, sem deriva */
+
+    arrivalDeadline(&sh->start, sh->arrival[passengerId], &at);
+    if (sleepUntil(&at) == -1)
+    {
+        perror("error on waiting for the arrival at the airport (PG)");
+        exit(EXIT_FAILURE);
+    }
 
     return true;
 }
 
+/**
+ *  \brief passenger leaves destination back to the airport (service mode)
+ *
+ *  The passenger updates its state and takes a random time to reach the airport.
+ *  The internal state should be saved.
+ *
+ *  \param passengerId passenger id
+ *  \param rng passenger random generator
+ */
+
+static void returnToAirport(unsigned int passengerId, PRNG *rng)
+{
+    /* critical region, left at the end of the block */
+    {
+        CRITICAL_REGION(semgid, sh->mutex, "PG.returnToAirport.state");
+        sh->fSt.st.passengerStat[passengerId] = GOING_TO_AIRPORT; // o passageiro regressa ao aeroporto
+        saveState(nFic, &sh->fSt);
+    }
+
+    usleep((unsigned int)floor(MAXTRAVEL * prngUniform(rng) + 1000));
+}
+
 /**
  *  \brief wait for its turn to be checked by hostess
  *
@@ -142,36 +345,78 @@ static bool travelToAirport()
  *  after being acknowledged by hostess passenger should provide its id to hostess and giver her permission to read the id
  *  The internal state should be saved twice.
  *
+ *  With the reduced-handshake protocol the passenger leaves its id in the queue and only waits for the hostess to
+ *  complete the check; the hostess updates the passenger state on its behalf.
+ *  A member of a party waits at the airport for the other members; the last one to arrive queues the whole party.
+ *  The passenger joins the queue of its destination. With the lock-free queue the id is published in the ring after
+ *  leaving the critical region.
+ *
  *  \param passengerId passenger id
  */
 
 static void waitInQueue(unsigned int passengerId)
 {   
-    /* enter critical region */
-    if (semDown(semgid, sh->mutex) == -1)
+    unsigned int nQueued = 1; // passageiros que entram na fila (o grupo inteiro quando o último membro chega)
+    unsigned int dest = sh->destination[passengerId]; // cada destino tem a sua fila
+
+    /* critical region, left at the end of the block */
     {
-        perror("error on the down operation for semaphore access (PG)");
-        exit(EXIT_FAILURE);
+        CRITICAL_REGION(semgid, sh->mutex, "PG.waitInQueue.enqueue");
+        sh->fSt.nPassInQueue++;                           // incrementa o número de passageiros que estão na fila de espera
+        sh->fSt.st.passengerStat[passengerId] = IN_QUEUE; // atualiza o estado do passageiro
+        sh->queued[passengerId] = elapsedSince(&sh->start); // início da espera
+        saveState(nFic, &sh->fSt);                        // regista o estado do passageiro
+        if (sh->fSt.par.maxGroup > 1)                     // viaja em grupo: espera pelos restantes membros
+        {
+            unsigned int g = sh->group[passengerId], m;
+
+            nQueued = 0;
+            if (++sh->gathered[g] == sh->groupSize[g])    // é o último a chegar e põe o grupo inteiro na fila
+            {
+                for (m = g; m < g + sh->groupSize[g]; m++)
+                    bqPush(&sh->queue[dest], m, sh->priority[m]);
+                nQueued = sh->groupSize[g];
+                sh->gathered[g] = 0;
+            }
+        }
+        else if (sh->fSt.par.fastBoarding && !sh->fSt.par.lockFree)
+            bqPush(&sh->queue[dest], passengerId, sh->priority[passengerId]); // deixa o id na fila da sua classe
     }
 
-    sh->fSt.nPassInQueue++;                           // incrementa o número de passageiros que estão na fila de espera
-    sh->fSt.st.passengerStat[passengerId] = IN_QUEUE; // atualiza o estado do passageiro
-    saveState(nFic, &sh->fSt);                        // regista o estado do passageiro
-
-    /* exit critical region */
-    if (semUp(semgid, sh->mutex) == -1) 
+    // fila sem bloqueio: publica o id fora da região crítica
+    if (sh->fSt.par.lockFree && (mpscPush(&sh->ring, passengerId) == -1))
     {
-        perror("error on the up operation for semaphore access (PG)");
+        perror("error on publishing the passenger id (PG)");
         exit(EXIT_FAILURE);
     }
 
     // Sinaliza à hospedeira que já há passageiros na fila de espera
-    if (semUp(semgid, sh->passengersInQueue) == -1)
+    if ((nQueued > 0) && (semUpMany(semgid, sh->passengersInQueue[dest], nQueued) == -1))
     {
         perror("error on the up operation for semaphore access (PG)");
         exit(EXIT_FAILURE);
     }
     
+    // protocolo reduzido: espera apenas que a hospedeira conclua o check-in
+    if (sh->fSt.par.mailbox)
+    {
+        if (mbExpect(&sh->passengerBox[passengerId], MSG_CHECK_DONE, NULL) == -1)
+        {
+            perror("error on receiving a message (PG)");
+            exit(EXIT_FAILURE);
+        }
+        return;
+    }
+    if (sh->fSt.par.fastBoarding)
+    {
+        if (semDown(semgid, sh->checkDone + passengerId) == -1)
+        {
+            perror("error on the down operation for semaphore access (PG)");
+            exit(EXIT_FAILURE);
+        }
+        return;
+    }
+
     // aguarda na fila de espera até ser atendido pela hospedeira
     if (semDown(semgid, sh->passengersWaitInQueue) == -1)
     {
@@ -180,23 +425,13 @@ static void waitInQueue(unsigned int passengerId)
     }
 
     // começa o check-in do passageiro
-    /* enter critical region */
-    if (semDown(semgid, sh->mutex) == -1)
+    /* critical region, left at the end of the block */
     {
-        perror("error on the down operation for semaphore access (PG)");
-        exit(EXIT_FAILURE);
-    }
-
+        CRITICAL_REGION(semgid, sh->mutex, "PG.waitInQueue.showId");
         sh->fSt.passengerChecked = passengerId;            // o passageiro fornece o seu id
+        sh->seat[passengerId] = sh->fSt.atGate;            // embarca no avião que está na porta
         sh->fSt.st.passengerStat[passengerId] = IN_FLIGHT; // entra no aviao
         saveState(nFic, &sh->fSt);                         // regista o estado
-
-    
-    /* exit critical region */
-    if (semUp(semgid, sh->mutex) == -1)
-    { 
-        perror("error on the up operation for semaphore access (PG)");
-        exit(EXIT_FAILURE);
     }
 
     // sinaliza à hospedeira que mostrou o ID e assim pode entrar no avião, finalizando o check-in
@@ -220,33 +455,43 @@ static void waitInQueue(unsigned int passengerId)
 
 static void waitUntilDestination(unsigned int passengerId)
 {
-    // sinaliza ao piloto que está a aguardar no avião
-    semDown(semgid, sh->passengersWaitInFlight);
-
-    /* enter critical region */
-    if (semDown(semgid, sh->mutex) == -1)
-    {
-        perror("error on the down operation for semaphore access (PG)");
-        exit(EXIT_FAILURE);
-    }
-
-    sh->fSt.st.passengerStat[passengerId] = AT_DESTINATION;     // o passageiro chegou ao seu destino
-    sh->fSt.nPassInFlight--;                                    // e consequentemente sai do avião
+    unsigned int plane = sh->seat[passengerId]; // avião em que embarcou
 
-    // caso o passageiro observe que é o ultimo a sair do aviáo, então avisa ao piloto que o avião encontra-se vazio
-    if (sh->fSt.nPassInFlight == 0)
+    // sinaliza ao piloto que está a aguardar no avião
+    if (sh->fSt.par.mailbox)
     {
-        if (semUp(semgid, sh->planeEmpty) == -1)
+        if (mbExpect(&sh->passengerBox[passengerId], MSG_DISEMBARK, NULL) == -1)
         {
-            perror("error on the up operation for semaphore access (PG)");
+            perror("error on receiving a message (PG)");
             exit(EXIT_FAILURE);
         }
     }
+    else
+        semDown(semgid, sh->passengersWaitInFlight[plane]);
 
-    /* enter critical region */
-    if (semUp(semgid, sh->mutex) == -1)
+    /* critical region, left at the end of the block */
     {
-        perror("error on the up operation for semaphore access (PG)");
-        exit(EXIT_FAILURE);
+        CRITICAL_REGION(semgid, sh->mutex, "PG.waitUntilDestination.leave");
+        sh->fSt.st.passengerStat[passengerId] = AT_DESTINATION;     // o passageiro chegou ao seu destino
+        sh->fSt.nPassInFlight--;                                    // e consequentemente sai do avião
+        sh->fSt.plane[plane].nPass--;
+
+        // caso o passageiro observe que é o ultimo a sair do aviáo, então avisa ao piloto que o avião encontra-se vazio
+        if (sh->fSt.plane[plane].nPass == 0)
+        {
+            if (sh->fSt.par.mailbox)
+            {
+                if (mbSend(&sh->pilotBox[plane], MSG_PLANE_EMPTY, plane) == -1)
+                {
+                    perror("error on sending a message (PG)");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            else if (semUp(semgid, sh->planeEmpty[plane]) == -1)
+            {
+                perror("error on the up operation for semaphore access (PG)");
+                exit(EXIT_FAILURE);
+            }
+        }
     }
 }
@@ -12,6 +12,17 @@
  *     \li waitUntilReadyToFlight
  *     \li dropPassengersAtTarget
  *
+ *  In a fleet of several planes there is one pilot per plane. Pilots take turns at the boarding gate: a pilot holds
+ *  the gate from the start of the boarding until the hostess signals that the plane is ready to flight.
+ *
+ *  With several destinations the pilot chooses the destination of each flight when the plane reaches the gate, and
+ *  farther destinations take longer flights.
+ *
+ *  With mailboxes the pilot opens the boarding and lets the passengers off with messages, and receives the end of
+ *  the boarding and the empty plane in its own mailbox.
+ *
+ *  The life cycle is driven by a transition table (pilotMachine), whose states run the operations above.
+ *
  *  \author Nuno Lau - January 2022
  */
 
@@ -31,7 +42,11 @@
 #include "logging.h"
 #include "sharedDataSync.h"
 #include "semaphore.h"
+#include "mailbox.h"
+#include "fsm.h"
+#include "critRegion.h"
 #include "sharedMemory.h"
+#include "prng.h"
 
 /** \brief logging file name */
 static char nFic[51];
@@ -45,11 +60,60 @@ static int semgid;
 /** \brief pointer to shared memory region */
 static SHARED_DATA *sh;
 
+/** \brief pilot random generator */
+static PRNG rng;
+
+/** \brief plane (and pilot) id */
+static unsigned int planeId = 0;
+
 static void flight(bool go);
-static void signalReadyForBoarding();
+static bool signalReadyForBoarding();
 static void waitUntilReadyToFlight();
 static void dropPassengersAtTarget();
 static bool isFinished();
+static unsigned int chooseDestination();
+
+/* estados do ciclo de vida do piloto */
+#define PT_START       0
+#define PT_FLY_BACK    1
+#define PT_OPEN        2
+#define PT_WAIT_BOARD  3
+#define PT_FLY         4
+#define PT_DROP        5
+#define PT_END         6
+
+static int doStart(void *ctx);
+static int doFlyBack(void *ctx);
+static int doOpen(void *ctx);
+static int doWaitBoard(void *ctx);
+static int doFly(void *ctx);
+static int doDrop(void *ctx);
+static bool finished(void *ctx);
+
+/** \brief states of the life cycle of the pilot */
+static const FSM_STATE pilotStates[PT_END + 1] = {
+    [PT_START] = {"start", doStart},
+    [PT_FLY_BACK] = {"flight back", doFlyBack},
+    [PT_OPEN] = {"signalReadyForBoarding", doOpen},
+    [PT_WAIT_BOARD] = {"waitUntilReadyToFlight", doWaitBoard},
+    [PT_FLY] = {"flight", doFly},
+    [PT_DROP] = {"dropPassengersAtTarget", doDrop},
+    [PT_END] = {"end", NULL}};
+
+/** \brief transitions of the life cycle of the pilot */
+static const FSM_TRANSITION pilotTrans[] = {
+    {PT_START, FSM_ANY, finished, PT_END},
+    {PT_START, FSM_ANY, NULL, PT_FLY_BACK},
+    {PT_FLY_BACK, EV_DONE, NULL, PT_OPEN},
+    {PT_OPEN, EV_FINISHED, NULL, PT_END},      // o air lift terminou enquanto esperava pela porta
+    {PT_OPEN, EV_DONE, NULL, PT_WAIT_BOARD},
+    {PT_WAIT_BOARD, EV_DONE, NULL, PT_FLY},
+    {PT_FLY, EV_DONE, NULL, PT_DROP},
+    {PT_DROP, EV_DONE, NULL, PT_START}};
+
+/** \brief life cycle of the pilot */
+static const FSM pilotMachine = {pilotStates, PT_END + 1, pilotTrans, sizeof(pilotTrans) / sizeof(pilotTrans[0]),
+                                 PT_START, PT_END};
 
 /**
  *  \brief Main program.
@@ -64,7 +128,7 @@ int main(int argc, char *argv[])
 
     /* validation of command line parameters */
 
-    if (argc != 4)
+    if ((argc != 4) && (argc != 5))
     {
         freopen("error_PT", "a", stderr);
         fprintf(stderr, "Number of parameters is incorrect!\n");
@@ -79,6 +143,15 @@ int main(int argc, char *argv[])
         fprintf(stderr, "Error on the access key communication!\n");
         return EXIT_FAILURE;
     }
+    if (argc == 5) // identificação do avião quando há vários
+    {
+        planeId = (unsigned int)strtol(argv[4], &tinp, 0);
+        if ((*tinp != '\0') || (planeId >= MAXPL))
+        {
+            fprintf(stderr, "Pilot process identification is wrong!\n");
+            return EXIT_FAILURE;
+        }
+    }
 
     /* connection to the semaphore set and the shared memory region and mapping the shared region onto the
        process address space */
@@ -98,18 +171,21 @@ int main(int argc, char *argv[])
         perror("error on mapping the shared region on the process address space");
         return EXIT_FAILURE;
     }
+    semCount(&sh->semOps); // contabiliza as operações sobre semáforos no total da simulação
+    if (sh->fSt.par.eventFd)
+        semUseEvents(sh->eventFd); // as esperas passam a ser feitas nos eventfd herdados do lançador
+    mbCount(&sh->msgOps); // contabiliza as mensagens enviadas no total da simulação
+    if (sh->fSt.par.lockStats)
+        crProfile(&sh->crProf); // regista os tempos de espera e de posse do mutex de cada região crítica
 
-    srandom((unsigned int)getpid()); /* initialize random generator */
+    prngInit(&rng, prngSeed(sh->fSt.par.seed, SEED_PILOT, planeId)); /* initialize random generator */
 
     /* simulation of the life cycle of the pilot */
 
-    while (!isFinished())
+    if ((fsmCheck(&pilotMachine) == -1) || (fsmRun(&pilotMachine, NULL) == -1))
     {
-        flight(false); // from target to origin
-        signalReadyForBoarding();
-        waitUntilReadyToFlight();
-        flight(true); // from origin to target
-        dropPassengersAtTarget();
+        perror("error on the life cycle of the pilot");
+        return EXIT_FAILURE;
     }
 
     /* unmapping the shared region off the process address space */
@@ -133,44 +209,125 @@ static bool isFinished()
 }
 
 /**
- *  \brief flight.
- *
- *  The pilot takes passenger to destination (go) or
- *  plane back to starting airport (return)
- *  state should be saved.
+ *  \brief actions and guards of the life cycle of the pilot
  *
- *  \param go true if going to destination
+ *  Each action runs one operation of the pilot and returns the event that took place.
  */
 
-static void flight(bool go)
+static int doStart(void *ctx)
 {
-    /* enter critical region */
+    return EV_DONE;
+}
 
-    if (semDown(semgid, sh->mutex) == -1)
-    {                                                                       
-        perror("error on the down operation for semaphore access (PT)");
-        exit(EXIT_FAILURE);
-    }
+static int doFlyBack(void *ctx)
+{
+    flight(false); // from target to origin
+    return EV_DONE;
+}
 
-    if (go)
+static int doOpen(void *ctx)
+{
+    return (signalReadyForBoarding()) ? EV_DONE : EV_FINISHED;
+}
+
+static int doWaitBoard(void *ctx)
+{
+    waitUntilReadyToFlight();
+    return EV_DONE;
+}
+
+static int doFly(void *ctx)
+{
+    flight(true); // from origin to target
+    return EV_DONE;
+}
+
+static int doDrop(void *ctx)
+{
+    dropPassengersAtTarget();
+    return EV_DONE;
+}
+
+static bool finished(void *ctx)
+{
+    return isFinished();
+}
+
+/**
+ *  \brief choice of the destination of the next flight
+ *
+ *  Only destinations with passengers still to board are eligible (in service mode, with any passenger). The longest
+ *  queue policy picks the destination with most passengers in queue, and then with most passengers still to board;
+ *  the cyclic policy picks the destinations in turn, after the one of the previous flight.
+ *  Must be called inside the critical region, after the flight number is updated.
+ *
+ *  \return destination
+ */
+
+static unsigned int chooseDestination()
+{
+    unsigned int d, c, best = 0, nDest = sh->fSt.par.nDest;
+    unsigned int len, bestLen = 0, left, bestLeft = 0;
+    bool found = false;
+
+    if (nDest <= 1)
+        return 0;
+    if (sh->fSt.par.routing == ROUTE_CYCLIC) // a seguir ao destino do voo anterior
     {
-        sh->fSt.st.pilotStat = FLYING;
+        d = (sh->fSt.nFlight > 1) ? sh->fSt.flightDest[(sh->fSt.nFlight - 2) % MAXNF] + 1 : 0;
+        for (c = 0; c < nDest; c++, d++)
+            if (sh->fSt.route[d % nDest].nPass > ((sh->fSt.par.service) ? 0 : sh->fSt.route[d % nDest].nBoarded))
+                return d % nDest;
+        return 0;
     }
-    else
+    for (d = 0; d < nDest; d++) // o destino com a fila mais longa
     {
-        sh->fSt.st.pilotStat = FLYING_BACK;
+        left = (sh->fSt.par.service) ? sh->fSt.route[d].nPass : sh->fSt.route[d].nPass - sh->fSt.route[d].nBoarded;
+        if (left == 0)
+            continue;
+        len = bqLength(&sh->queue[d]);
+        if (!found || (len > bestLen) || ((len == bestLen) && (left > bestLeft)))
+        {
+            best = d;
+            bestLen = len;
+            bestLeft = left;
+            found = true;
+        }
     }
-    saveState(nFic, &sh->fSt);
+    return best;
+}
 
-    /* exit critical region */
+/**
+ *  \brief flight.
+ *
+ *  The pilot takes passenger to destination (go) or
+ *  plane back to starting airport (return)
+ *  state should be saved.
+ *
+ *  \param go true if going to destination
+ *
+ *  The duration of both legs grows with the distance to the destination of the plane.
+ */
 
-    if (semUp(semgid, sh->mutex) == -1)
-    {                                                                       
-        perror("error on the up operation for semaphore access (PT)");
-        exit(EXIT_FAILURE);
+static void flight(bool go)
+{
+    /* critical region, left at the end of the block */
+    {
+        CRITICAL_REGION(semgid, sh->mutex, "PT.flight.state");
+        if (go)
+        {
+            sh->fSt.st.pilotStat[planeId] = FLYING;
+        }
+        else
+        {
+            sh->fSt.st.pilotStat[planeId] = FLYING_BACK;
+        }
+        saveState(nFic, &sh->fSt);
     }
 
-    usleep((unsigned int)floor((MAXFLIGHT * random()) / RAND_MAX + 100.0));
+    // os destinos mais afastados levam mais tempo a alcançar
+    usleep((unsigned int)floor((MAXFLIGHT * prngUniform(&rng) + 100.0) *
+                               (1.0 + ROUTE_STRETCH * sh->fSt.plane[planeId].dest)));
 }
 
 /**
@@ -179,35 +336,83 @@ static void flight(bool go)
  *  The pilot updates its state and signals the hostess that boarding may start
  *  The flight number should be updated.
  *  The internal state should be saved.
+ *
+ *  In a fleet of several planes the pilot first waits for its turn at the boarding gate.
+ *  The destination of the flight is chosen by the routing policy.
+ *  With pipelined boarding, if the hostess is pre-checking passengers she is woken up through passengersInQueue.
+ *
+ *  \return false if the air lift finished while the pilot was waiting for the gate
  */
 
-static void signalReadyForBoarding()
+static bool signalReadyForBoarding()
 {
-    /* enter critical region */
-    if (semDown(semgid, sh->mutex) == -1)
-    { 
+    bool ring; // embarque em pipeline: acorda a hospedeira pela fila
+
+    // com vários aviões, espera pela vez na porta de embarque
+    if ((sh->fSt.par.nPlanes > 1) && (semDown(semgid, sh->gate) == -1))
+    {
         perror("error on the down operation for semaphore access (PT)");
         exit(EXIT_FAILURE);
     }
 
-    sh->fSt.st.pilotStat = READY_FOR_BOARDING; // o piloto fica no estado READY_FOR_BOARDING
-    sh->fSt.nFlight++;                         // incrementa o ID do voo
-    saveState(nFic, &sh->fSt);                 // guarda o estado do piloto
-    saveStartBoarding(nFic, &sh->fSt);         // emite anuncio a anunciar o começo do boarding
+    /* critical region, left at the end of the block */
+    {
+        CRITICAL_REGION(semgid, sh->mutex, "PT.signalReadyForBoarding.open");
+        if (sh->fSt.par.nPlanes > 1)
+        {
+            // em modo de serviço, não embarca mais voos do que os configurados
+            if (sh->fSt.par.service && sh->fSt.par.maxFlights > 0 && sh->fSt.nFlight >= sh->fSt.par.maxFlights)
+            {
+                sh->fSt.finished = true;
+            }
+            // o air lift terminou: cede a porta ao piloto seguinte e termina (o mutex é libertado ao sair do bloco)
+            if (sh->fSt.finished)
+            {
+                if (semUp(semgid, sh->gate) == -1)
+                {
+                    perror("error on the up operation for semaphore access (PT)");
+                    exit(EXIT_FAILURE);
+                }
+                return false;
+            }
+        }
 
-    /* exit critical region */
-    if (semUp(semgid, sh->mutex) == -1)
-    { 
-        perror("error on the up operation for semaphore access (PT)");
-        exit(EXIT_FAILURE);
+        sh->fSt.st.pilotStat[planeId] = READY_FOR_BOARDING; // o piloto fica no estado READY_FOR_BOARDING
+        sh->fSt.nFlight++;                         // incrementa o ID do voo
+        sh->fSt.plane[planeId].flight = sh->fSt.nFlight;            // o avião fica associado ao voo
+        sh->fSt.flightPlane[(sh->fSt.nFlight - 1) % MAXNF] = planeId;
+        sh->fSt.plane[planeId].dest = chooseDestination(); // escolhe o destino do voo
+        sh->fSt.flightDest[(sh->fSt.nFlight - 1) % MAXNF] = sh->fSt.plane[planeId].dest;
+        sh->fSt.route[sh->fSt.plane[planeId].dest].nFlights++;
+        sh->fSt.atGate = planeId;                  // e ocupa a porta de embarque
+        sh->boarding = true;                       // abre o embarque a todas as hospedeiras
+        ring = sh->doorbell;                       // a hospedeira está a pré-verificar passageiros
+        if (ring)
+            sh->spare++;
+        saveState(nFic, &sh->fSt);                 // guarda o estado do piloto
+        saveStartBoarding(nFic, &sh->fSt);         // emite anuncio a anunciar o começo do boarding
+    }
+
+    // caixas de correio: a abertura do embarque é uma mensagem para a hospedeira
+    if (sh->fSt.par.mailbox)
+    {
+        if (mbSend(&sh->hostessBox, MSG_BOARDING_OPEN, sh->fSt.plane[planeId].flight) == -1)
+        {
+            perror("error on sending a message (PT)");
+            exit(EXIT_FAILURE);
+        }
+        return true;
     }
 
-    // sinaliza à hospedeira que o boarding já pode começar
-    if (semUp(semgid, sh->readyForBoarding) == -1)
+    // sinaliza às hospedeiras que o boarding já pode começar
+    if ((ring && (semUp(semgid, sh->passengersInQueue[sh->fSt.plane[planeId].dest]) == -1)) ||
+        (!ring && (semUpMany(semgid, sh->readyForBoarding, sh->fSt.par.nHostess) == -1)))
     {
         perror("error on the up operation for semaphore access (PT)");
         exit(EXIT_FAILURE);
     }
+
+    return true;
 }
 
 /**
@@ -215,31 +420,37 @@ static void signalReadyForBoarding()
  *
  *  The pilot updates its state and wait for Boarding to finish
  *  The internal state should be saved.
+ *  In a fleet of several planes the pilot then leaves the boarding gate to the next one.
  */
 
 static void waitUntilReadyToFlight()
 {
-    /* enter critical region */
-    if (semDown(semgid, sh->mutex) == -1)
-    { 
-        perror("error on the down operation for semaphore access (PT)");
-        exit(EXIT_FAILURE);
+    /* critical region, left at the end of the block */
+    {
+        CRITICAL_REGION(semgid, sh->mutex, "PT.waitUntilReadyToFlight.state");
+        sh->fSt.st.pilotStat[planeId] = WAITING_FOR_BOARDING;    // muda o estado do piloto para WAITING_FOR_BOARDING
+        saveState(nFic, &sh->fSt);                      // guarda o estado do piloto
     }
 
-    sh->fSt.st.pilotStat = WAITING_FOR_BOARDING;    // muda o estado do piloto para WAITING_FOR_BOARDING
-    saveState(nFic, &sh->fSt);                      // guarda o estado do piloto
-
-    /* exit critical region */
-    if (semUp(semgid, sh->mutex) == -1)
+     // o piloto espera que o boarding acabe
+    if (sh->fSt.par.mailbox)
     {
-        perror("error on the up operation for semaphore access (PT)");
+        if (mbExpect(&sh->pilotBox[planeId], MSG_BOARDING_DONE, NULL) == -1)
+        {
+            perror("error on receiving a message (PT)");
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (semDown(semgid, sh->readyToFlight[planeId]) == -1)
+    {
+        perror("error on the down operation for semaphore access (PT)");
         exit(EXIT_FAILURE);
     }
 
-     // o piloto espera que o boarding acabe
-    if (semDown(semgid, sh->readyToFlight) == -1)
+    // liberta a porta de embarque
+    if ((sh->fSt.par.nPlanes > 1) && (semUp(semgid, sh->gate) == -1))
     {
-        perror("error on the down operation for semaphore access (PT)");
+        perror("error on the up operation for semaphore access (PT)");
         exit(EXIT_FAILURE);
     }
 }
@@ -254,55 +465,59 @@ static void waitUntilReadyToFlight()
 
 static void dropPassengersAtTarget()
 {
-    /* enter critical region */
-    if (semDown(semgid, sh->mutex) == -1)
-    { 
-        perror("error on the down operation for semaphore access (PT)");
-        exit(EXIT_FAILURE);
-    }
+    /* critical region, left at the end of the block */
+    {
+        CRITICAL_REGION(semgid, sh->mutex, "PT.dropPassengers.arrive");
+        saveFlightArrived(nFic, &sh->fSt, planeId); // emite anuncio que o avião chegou ao destino
+        sh->fSt.plane[planeId].nFlights++;
+        sh->fSt.plane[planeId].nCarried += sh->fSt.plane[planeId].nPass;
+        sh->fSt.st.pilotStat[planeId] = DROPING_PASSENGERS;  // muda o estado do piloto para DROPING_PASSENGERS
+        saveState(nFic, &sh->fSt);                  // guarda o estado
 
- 
-    saveFlightArrived(nFic, &sh->fSt); // emite anuncio que o avião chegou ao destino
-    sh->fSt.st.pilotStat = DROPING_PASSENGERS;  // muda o estado do piloto para DROPING_PASSENGERS
-    saveState(nFic, &sh->fSt);                  // guarda o estado
 
+        // para cada passageiro dentro do avião, o piloto sinaliza que pode desembarcar
+        for (int i = sh->fSt.plane[planeId].nPass; i > 0; i--)
+        {
+            if (sh->fSt.par.mailbox) // caixas de correio: uma mensagem a cada passageiro a bordo
+            {
+                if (mbSend(&sh->passengerBox[sh->onBoard[planeId][i - 1]], MSG_DISEMBARK, planeId) == -1)
+                {
+                    perror("error on sending a message (PT)");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            else if (semUp(semgid, sh->passengersWaitInFlight[planeId]) == -1)
+            {
+                perror("error on the up operation for semaphore access (PT)");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
 
-    // para cada passageiro dentro do avião, o piloto sinaliza que pode desembarcar
-    for (int i = sh->fSt.nPassInFlight; i > 0; i--)
+    // o piloto espera que o último passageiro saia do avião
+    if (sh->fSt.par.mailbox)
     {
-        if (semUp(semgid, sh->passengersWaitInFlight) == -1)
+        if (mbExpect(&sh->pilotBox[planeId], MSG_PLANE_EMPTY, NULL) == -1)
         {
-            perror("error on the up operation for semaphore access (PT)");
+            perror("error on receiving a message (PT)");
             exit(EXIT_FAILURE);
         }
     }
-     /* exit critical region */
-    if (semUp(semgid, sh->mutex) == -1)
+    else if (semDown(semgid, sh->planeEmpty[planeId]) == -1)
     {
         perror("error on the up operation for semaphore access (PT)");
         exit(EXIT_FAILURE);
     }
 
-    // o piloto espera que o último passageiro saia do avião
-    if (semDown(semgid, sh->planeEmpty) == -1)
+    /* critical region, left at the end of the block */
     {
-        perror("error on the up operation for semaphore access (PT)");
-        exit(EXIT_FAILURE);
-    }
+        CRITICAL_REGION(semgid, sh->mutex, "PT.dropPassengers.return");
+        saveFlightReturning(nFic, &sh->fSt, planeId);        // faz o anuncio do voo em retorno
 
-    /* enter critical region */
-    if (semDown(semgid, sh->mutex) == -1)
-    { 
-        perror("error on the down operation for semaphore access (PT)");
-        exit(EXIT_FAILURE);
-    }
-
-    saveFlightReturning(nFic, &sh->fSt);        // faz o anuncio do voo em retorno
-
-    /* exit critical region */
-    if (semUp(semgid, sh->mutex) == -1)
-    {
-        perror("error on the up operation for semaphore access (PT)");
-        exit(EXIT_FAILURE);
+        // em modo de serviço, termina quando o número de voos configurado é atingido
+        if (sh->fSt.par.service && sh->fSt.par.maxFlights > 0 && sh->fSt.nFlight >= sh->fSt.par.maxFlights)
+        {
+            sh->fSt.finished = true;
+        }
     }
 }
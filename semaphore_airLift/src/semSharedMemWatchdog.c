@@ -0,0 +1,298 @@
+/**
+ *  \file semSharedMemWatchdog.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift
+ *
+ *  Synchronization based on semaphores and shared memory.
+ *  Implementation with SVIPC.
+ *
+ *  Definition of the operations carried out by the watchdog:
+ *     \li takeSample
+ *     \li dumpSnapshot
+ *     \li arrivalPending
+ *
+ *  The watchdog samples the full state of the problem and the semaphore values without entering the critical
+ *  region. If nothing changes during the configured stall period, it writes a diagnostic snapshot to its error file
+ *  and terminates the run by signalling the launcher, which removes the entities and the IPC resources.
+ *  While some passenger has yet to arrive at the airport an idle run is waiting for it, so nothing counts as a stall
+ *  until the arrival time of the last passenger has passed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "logging.h"
+#include "sharedDataSync.h"
+#include "semaphore.h"
+#include "sharedMemory.h"
+#include "arrivals.h"
+
+/** \brief sampling period (us) */
+#define SAMPLE_PERIOD 200000
+
+/** \brief logging file name */
+static char nFic[51];
+
+/** \brief shared memory block access identifier */
+static int shmid;
+
+/** \brief semaphore set access identifier */
+static int semgid;
+
+/** \brief pointer to shared memory region */
+static SHARED_DATA *sh;
+
+/** \brief arrival times of the passengers, in increasing order (us after start of operations) */
+static unsigned long arrival[N];
+
+/** \brief first arrival not yet passed */
+static unsigned int nextArrival = 0;
+
+/**
+ *  \brief Definition of <em>sample</em> data type.
+ */
+typedef struct
+{ /** \brief copy of the full state of the problem */
+    FULL_STAT fSt;
+    /** \brief semaphore values */
+    int val[SEM_NU + 1];
+    /** \brief number of processes blocked on each semaphore */
+    int ncnt[SEM_NU + 1];
+
+} SAMPLE;
+
+/** \brief semaphore names, by location in the set (up to the semaphores of the first plane and the gate) */
+static const char *semName[PLANESEMS] = {"start", "mutex", "passengersInQueue", "passengersWaitInQueue",
+                                         "passengersWaitInFlight", "readyForBoarding", "readyToFlight",
+                                         "idShown", "planeEmpty", "gate"};
+
+/** \brief names of the semaphores of each plane other than the first one, in order of location */
+static const char *planeSemName[3] = {"passengersWaitInFlight", "readyToFlight", "planeEmpty"};
+
+static void takeSample(SAMPLE *s);
+static void dumpSnapshot(const SAMPLE *s, double stalled);
+static void stopWatching(int sig);
+static bool arrivalPending();
+static int byTime(const void *a, const void *b);
+
+/**
+ *  \brief Main program.
+ *
+ *  Its role is to watch the progress of the intervening entities in the problem.
+ */
+
+int main(int argc, char *argv[])
+{
+    int key;    /*access key to shared memory and semaphore set */
+    char *tinp; /* numerical parameters test flag */
+    SAMPLE prev, cur; /* previous and current samples */
+    struct timespec now, lastChange;
+    double stalled;
+
+    /* validation of command line parameters */
+
+    if (argc != 4)
+    {
+        freopen("error_WD", "a", stderr);
+        fprintf(stderr, "Number of parameters is incorrect!\n");
+        return EXIT_FAILURE;
+    }
+    else
+        freopen(argv[3], "w", stderr);
+    strcpy(nFic, argv[1]);
+    key = (unsigned int)strtol(argv[2], &tinp, 0);
+    if (*tinp != '\0')
+    {
+        fprintf(stderr, "Error on the access key communication!\n");
+        return EXIT_FAILURE;
+    }
+
+    /* the launcher terminates the watchdog when the run is over */
+
+    signal(SIGTERM, stopWatching);
+
+    /* connection to the semaphore set and the shared memory region and mapping the shared region onto the
+       process address space */
+
+    if ((semgid = semConnect(key)) == -1)
+    {
+        perror("error on connecting to the semaphore set");
+        return EXIT_FAILURE;
+    }
+    if ((shmid = shmemConnect(key)) == -1)
+    {
+        perror("error on connecting to the shared memory region");
+        return EXIT_FAILURE;
+    }
+    if (shmemAttach(shmid, (void **)&sh) == -1)
+    {
+        perror("error on mapping the shared region on the process address space");
+        return EXIT_FAILURE;
+    }
+    if (sh->fSt.par.eventFd)
+        semUseEvents(sh->eventFd); // os valores passam a ser lidos dos eventfd herdados do lançador
+
+    memcpy(arrival, sh->arrival, sizeof(arrival)); // as chegadas por ordem temporal
+    qsort(arrival, N, sizeof(arrival[0]), byTime);
+
+    /* watching the progress of the run */
+
+    takeSample(&prev);
+    clock_gettime(CLOCK_MONOTONIC, &lastChange);
+    while (true)
+    {
+        usleep(SAMPLE_PERIOD);
+        takeSample(&cur);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (memcmp(&cur, &prev, sizeof(SAMPLE)) != 0)
+        {
+            prev = cur;
+            lastChange = now;
+            continue;
+        }
+        if (arrivalPending()) // a inatividade é a espera por um passageiro que ainda não chegou
+        {
+            lastChange = now;
+            continue;
+        }
+        stalled = (now.tv_sec - lastChange.tv_sec) + (now.tv_nsec - lastChange.tv_nsec) / 1e9;
+        if (stalled >= sh->fSt.par.stall)
+        {
+            dumpSnapshot(&cur, stalled);
+            saveStall(nFic, stalled);
+            kill(getppid(), SIGTERM); // o lançador termina as entidades e remove os recursos IPC
+            break;
+        }
+    }
+
+    /* unmapping the shared region off the process address space */
+
+    if (shmemDettach(sh) == -1)
+    {
+        perror("error on unmapping the shared region off the process address space");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_FAILURE;
+}
+
+/**
+ *  \brief some passenger has yet to arrive at the airport
+ *
+ *  \return true if the start of operations was not signaled yet or the arrival time of some passenger is still ahead
+ */
+
+static bool arrivalPending()
+{
+    unsigned long t;
+
+    if ((sh->start.tv_sec == 0) && (sh->start.tv_nsec == 0)) // o lançador ainda não sinalizou o início
+        return true;
+    t = elapsedSince(&sh->start);
+    while ((nextArrival < N) && (arrival[nextArrival] <= t))
+        nextArrival++;
+    return nextArrival < N;
+}
+
+/**
+ *  \brief comparison of two arrival times, for qsort
+ */
+
+static int byTime(const void *a, const void *b)
+{
+    unsigned long x = *(const unsigned long *)a, y = *(const unsigned long *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ *  \brief take a sample of the progress of the run
+ *
+ *  The full state is copied without entering the critical region; a torn copy only counts as a change.
+ *
+ *  \param s pointer to the location where the sample is stored
+ */
+
+static void takeSample(SAMPLE *s)
+{
+    unsigned int i;
+
+    memset(s, 0, sizeof(SAMPLE));
+    memcpy(&s->fSt, (const void *)&sh->fSt, sizeof(FULL_STAT));
+    for (i = 0; i <= SEM_NU; i++)
+    {
+        s->val[i] = semGetVal(semgid, i);
+        s->ncnt[i] = semGetNcnt(semgid, i);
+    }
+}
+
+/**
+ *  \brief write a diagnostic snapshot to the error file
+ *
+ *  \param s pointer to the last sample
+ *  \param stalled time without progress (s)
+ */
+
+static void dumpSnapshot(const SAMPLE *s, double stalled)
+{
+    unsigned int i, p;
+
+    fprintf(stderr, "Watchdog: no progress for %.2f s (master seed %llu)\n", stalled,
+            (unsigned long long)s->fSt.par.seed);
+    fprintf(stderr, "pilot");
+    for (i = 0; (i == 0) || (i < s->fSt.par.nPlanes); i++)
+        fprintf(stderr, " %u", s->fSt.st.pilotStat[i]);
+    fprintf(stderr, " hostess");
+    for (i = 0; (i == 0) || (i < s->fSt.par.nHostess); i++)
+        fprintf(stderr, " %u", s->fSt.st.hostessStat[i]);
+    fprintf(stderr, " flight %u finished %d\n", s->fSt.nFlight, s->fSt.finished);
+    for (i = 0; i < s->fSt.par.nPlanes; i++)
+        fprintf(stderr, "plane %u flight %u dest %u onBoard %u%s\n", i, s->fSt.plane[i].flight, s->fSt.plane[i].dest,
+                s->fSt.plane[i].nPass, (i == s->fSt.atGate) ? " atGate" : "");
+    fprintf(stderr, "inQueue %u inFlight %u boarded %u lastChecked %d\n", s->fSt.nPassInQueue,
+            s->fSt.nPassInFlight, s->fSt.totalPassBoarded, s->fSt.passengerChecked);
+    fprintf(stderr, "passengers");
+    for (p = 0; p < N; p++)
+    {
+        fprintf(stderr, " %u", s->fSt.st.passengerStat[p]);
+    }
+    fprintf(stderr, "\n%-24s %6s %6s\n", "semaphore", "value", "ncnt");
+    for (i = 0; i < PLANESEMS; i++)
+    {
+        fprintf(stderr, "%-24s %6d %6d\n", semName[i], s->val[i], s->ncnt[i]);
+    }
+    for (i = PLANESEMS; i < PLANESEMS + 3 * (s->fSt.par.nPlanes - 1); i++)
+    {
+        char name[32];
+
+        snprintf(name, sizeof(name), "%s[%u]", planeSemName[(i - PLANESEMS) % 3], (i - PLANESEMS) / 3 + 1);
+        fprintf(stderr, "%-24s %6d %6d\n", name, s->val[i], s->ncnt[i]);
+    }
+    for (i = DESTSEMS; i < DESTSEMS + s->fSt.par.nDest - 1; i++)
+    {
+        char name[32];
+
+        snprintf(name, sizeof(name), "passengersInQueue[%u]", i - DESTSEMS + 1);
+        fprintf(stderr, "%-24s %6d %6d\n", name, s->val[i], s->ncnt[i]);
+    }
+    fflush(stderr);
+}
+
+/**
+ *  \brief termination signal handler
+ *
+ *  \param sig signal number
+ */
+
+static void stopWatching(int sig)
+{
+    _exit(EXIT_SUCCESS);
+}
@@ -7,21 +7,126 @@
  *     \li creation of a set of semaphores
  *     \li connection to a previously created set of semaphores
  *     \li destruction of a previously created set of semaphores
+ *     \li lookup of a previously created set of semaphores
  *     \li signalling start of operations
  *     \li <em>down</em> of a semaphore within the set
- *     \li <em>up</em> of a semaphore within the set.
+ *     \li <em>down</em> of a semaphore within the set with a timeout
+ *     \li <em>up</em> of a semaphore within the set
+ *     \li <em>down</em> of a semaphore within the set several times at once
+ *     \li <em>up</em> of several semaphores within the set at once
+ *     \li <em>up</em> of a semaphore within the set several times at once
+ *     \li identification of the last process that operated on a semaphore within the set
+ *     \li value of a semaphore within the set
+ *     \li number of processes waiting on a semaphore within the set
+ *     \li counting of the <em>down</em> and <em>up</em> operations
+ *     \li creation of a set of event file descriptors
+ *     \li closing of a set of event file descriptors
+ *     \li switching the <em>down</em> and <em>up</em> operations to event file descriptors.
+ *
+ *  With the event file descriptors backend, each semaphore within the set but the start of operations one is mapped
+ *  onto an <tt>eventfd</tt> in semaphore mode: an <em>up</em> adds to its counter and a <em>down</em> waits with
+ *  <tt>poll</tt> until one unit can be read. The descriptors are inherited across <tt>fork</tt> and <tt>exec</tt>.
  *
  *  \author António Rui Borges - October 1995
  */
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
 #include <sys/sem.h>
+#include <sys/eventfd.h>
+
+#include "semaphore.h"
 
 /** \brief access permission: user r-w */
 #define  MASK           0600
 
+/** \brief max number of semaphores operated at once */
+#define  MAXOPS          64
+
+/** \brief counter of down and up operations, if any */
+static unsigned long *opCount = NULL;
+
+/** \brief event file descriptor of each semaphore within the set, if the backend is in use */
+static const int *evFd = NULL;
+
+/**
+ *  \brief <em>Down</em> of an event file descriptor.
+ *
+ *  \param fd event file descriptor
+ *  \param timeout max waiting time (\c NULL waits forever)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+static int evDown (int fd, const struct timespec *timeout)
+{
+  struct pollfd pfd = { fd, POLLIN, 0 };
+  struct timespec deadline, now, left;
+  uint64_t unit;
+  int ready;
+
+  if (timeout != NULL)
+     { clock_gettime (CLOCK_MONOTONIC, &deadline);
+       deadline.tv_sec += timeout->tv_sec;
+       deadline.tv_nsec += timeout->tv_nsec;
+       if (deadline.tv_nsec >= 1000000000)
+          { deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+          }
+     }
+  for (;;)
+  { if (read (fd, &unit, sizeof (unit)) == sizeof (unit))                 /* semaphore mode: one unit at a time */
+       return 0;
+    if (errno != EAGAIN)
+       return -1;
+    if (timeout == NULL)
+       ready = ppoll (&pfd, 1, NULL, NULL);
+       else { clock_gettime (CLOCK_MONOTONIC, &now);
+              left.tv_sec = deadline.tv_sec - now.tv_sec;
+              left.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+              if (left.tv_nsec < 0)
+                 { left.tv_sec--;
+                   left.tv_nsec += 1000000000;
+                 }
+              if (left.tv_sec < 0)
+                 left.tv_sec = left.tv_nsec = 0;
+              ready = ppoll (&pfd, 1, &left, NULL);
+            }
+    if (ready == -1)
+       return -1;
+    if (ready == 0)
+       { errno = EAGAIN;
+         return -1;
+       }
+  }                                                          /* another waiter may have taken the unit meanwhile */
+}
+
+/**
+ *  \brief <em>Up</em> of an event file descriptor several times at once.
+ *
+ *  \param fd event file descriptor
+ *  \param n number of <em>up</em>s
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+static int evUp (int fd, unsigned int n)
+{
+  uint64_t units = n;
+
+  return (write (fd, &units, sizeof (units)) == sizeof (units)) ? 0 : -1;
+}
+
 /**
  *  \brief Creation of a set of semaphores.
  *
@@ -79,6 +184,23 @@ int semDestroy (int semgid)
   return semctl (semgid, 0, IPC_RMID, NULL);
 }
 
+/**
+ *  \brief Lookup of a previously created set of semaphores.
+ *
+ *  Unlike <tt>semConnect</tt>, it does not wait for the start of operations.
+ *  The function fails if there is no semaphore set with a creation key equal to <tt>key</tt>.
+ *
+ *  \param key creation key
+ *
+ *  \return set identifier, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semLookup (int key)
+{
+  return semget ((key_t) key, 0, MASK);
+}
+
 /**
  *  \brief Signalling start of operations upon initialization of shared data structures.
  *
@@ -114,9 +236,44 @@ int semDown (int semgid, unsigned int sindex)
   struct sembuf down = { 0, -1, 0 };                                                      /* specific down operation */
 
   down.sem_num = (unsigned short) sindex;
+  if (opCount != NULL)
+     __atomic_fetch_add (opCount, 1, __ATOMIC_RELAXED);
+  if (evFd != NULL)
+     return evDown (evFd[sindex], NULL);
   return semop (semgid, &down, 1);
 }
 
+/**
+ *  \brief <em>Down</em> of a semaphore within the set with a timeout.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or if the semaphore
+ *  can not be decremented within <tt>timeout</tt> seconds (<tt>errno</tt> is then set to <tt>EAGAIN</tt>).
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param timeout max waiting time (s)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semDownTimed (int semgid, unsigned int sindex, double timeout)
+{
+  struct sembuf down = { 0, -1, 0 };                                                      /* specific down operation */
+  struct timespec t;                                                                         /* max waiting time */
+
+  if (timeout < 0.0)
+     timeout = 0.0;
+  t.tv_sec = (time_t) timeout;
+  t.tv_nsec = (long) ((timeout - t.tv_sec) * 1e9);
+  down.sem_num = (unsigned short) sindex;
+  if (opCount != NULL)
+     __atomic_fetch_add (opCount, 1, __ATOMIC_RELAXED);
+  if (evFd != NULL)
+     return evDown (evFd[sindex], &t);
+  return semtimedop (semgid, &down, 1, &t);
+}
+
 /**
  *  \brief <em>Up</em> of a semaphore within the set.
  *
@@ -134,5 +291,267 @@ int semUp (int semgid, unsigned int sindex)
   struct sembuf up = { 0, 1, 0 };                                                           /* specific up operation */
 
   up.sem_num = (unsigned short) sindex;
+  if (opCount != NULL)
+     __atomic_fetch_add (opCount, 1, __ATOMIC_RELAXED);
+  if (evFd != NULL)
+     return evUp (evFd[sindex], 1);
   return semop (semgid, &up, 1);
 }
+
+/**
+ *  \brief <em>Down</em> of a semaphore within the set several times at once.
+ *
+ *  The process blocks until the semaphore value is at least <tt>n</tt> and then decrements it by <tt>n</tt> (with
+ *  the event file descriptors backend, the units are taken one at a time, so the semaphore must have a single
+ *  waiter).
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param n number of <em>down</em>s
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semDownMany (int semgid, unsigned int sindex, unsigned int n)
+{
+  struct sembuf down = { 0, -1, 0 };                                                    /* specific down operation */
+
+  down.sem_num = (unsigned short) sindex;
+  down.sem_op = (short) -n;
+  if (opCount != NULL)
+     __atomic_fetch_add (opCount, 1, __ATOMIC_RELAXED);
+  if (evFd != NULL)
+     { while (n-- > 0)
+         if (evDown (evFd[sindex], NULL) == -1)
+            return -1;
+       return 0;
+     }
+  return semop (semgid, &down, 1);
+}
+
+/**
+ *  \brief <em>Up</em> of several semaphores within the set at once.
+ *
+ *  All the semaphores are incremented in a single atomic operation (one after the other with the event file
+ *  descriptors backend).
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or if <tt>n</tt>
+ *  exceeds the maximum number of operations per call.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphores location in the set (1 .. snum)
+ *  \param n number of semaphores
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semUpEach (int semgid, unsigned int sindex[], unsigned int n)
+{
+  struct sembuf up[MAXOPS];                                                               /* specific up operations */
+  unsigned int i;
+
+  if (n > MAXOPS)
+     { errno = E2BIG;
+       return -1;
+     }
+  for (i = 0; i < n; i++)
+  { up[i].sem_num = (unsigned short) sindex[i];
+    up[i].sem_op = 1;
+    up[i].sem_flg = 0;
+  }
+  if (opCount != NULL)
+     __atomic_fetch_add (opCount, 1, __ATOMIC_RELAXED);
+  if (evFd != NULL)
+     { for (i = 0; i < n; i++)
+         if (evUp (evFd[sindex[i]], 1) == -1)
+            return -1;
+       return 0;
+     }
+  return semop (semgid, up, n);
+}
+
+/**
+ *  \brief <em>Up</em> of a semaphore within the set several times at once.
+ *
+ *  The semaphore value is incremented by <tt>n</tt>.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param n number of <em>up</em>s
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semUpMany (int semgid, unsigned int sindex, unsigned int n)
+{
+  struct sembuf up = { 0, 1, 0 };                                                           /* specific up operation */
+
+  up.sem_num = (unsigned short) sindex;
+  up.sem_op = (short) n;
+  if (opCount != NULL)
+     __atomic_fetch_add (opCount, 1, __ATOMIC_RELAXED);
+  if (evFd != NULL)
+     return evUp (evFd[sindex], n);
+  return semop (semgid, &up, 1);
+}
+
+/**
+ *  \brief Identification of the last process that operated on a semaphore within the set.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or if
+ *  <tt>sindex</tt> is out of range.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (0 .. snum)
+ *
+ *  \return process identifier (\c 0 if no operation took place), upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semLastPid (int semgid, unsigned int sindex)
+{
+  return semctl (semgid, (int) sindex, GETPID);
+}
+
+/**
+ *  \brief Value of a semaphore within the set.
+ *
+ *  With the event file descriptors backend, the counter of the descriptor is read from <tt>/proc</tt>.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or if
+ *  <tt>sindex</tt> is out of range.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (0 .. snum)
+ *
+ *  \return semaphore value, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semGetVal (int semgid, unsigned int sindex)
+{
+  char path[64];                                                                  /* descriptor information file */
+  FILE *info;
+  unsigned long long count;
+
+  if ((evFd == NULL) || (sindex == 0))
+     return semctl (semgid, (int) sindex, GETVAL);
+  snprintf (path, sizeof (path), "/proc/self/fdinfo/%d", evFd[sindex]);
+  if ((info = fopen (path, "r")) == NULL)
+     return -1;
+  while (fscanf (info, "eventfd-count: %llx", &count) != 1)
+    if (fscanf (info, "%*[^\n]\n") == EOF)
+       { fclose (info);
+         errno = ENOTSUP;
+         return -1;
+       }
+  fclose (info);
+  return (int) count;
+}
+
+/**
+ *  \brief Number of processes waiting on a semaphore within the set.
+ *
+ *  Only processes waiting for the value to increase (blocked <em>down</em> operations) are counted.
+ *  The waiters of an event file descriptor can not be counted, so the function fails with <tt>ENOTSUP</tt> when that
+ *  backend is in use.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or if
+ *  <tt>sindex</tt> is out of range.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (0 .. snum)
+ *
+ *  \return number of waiting processes, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semGetNcnt (int semgid, unsigned int sindex)
+{
+  if ((evFd != NULL) && (sindex != 0))
+     { errno = ENOTSUP;
+       return -1;
+     }
+  return semctl (semgid, (int) sindex, GETNCNT);
+}
+
+/**
+ *  \brief Counting of the <em>down</em> and <em>up</em> operations.
+ *
+ *  From now on, every <em>down</em> and <em>up</em> carried out by the calling process increments
+ *  <tt>*counter</tt> atomically (an operation on several semaphores at once counts as one). The counter may live in
+ *  a shared memory region, so it is shared by several processes.
+ *
+ *  \param counter pointer to the counter (\c NULL stops counting)
+ */
+
+void semCount (unsigned long *counter)
+{
+  opCount = counter;
+}
+
+/**
+ *  \brief Creation of a set of event file descriptors.
+ *
+ *  One descriptor is created in semaphore mode for each semaphore within a set of <tt>snum</tt> semaphores, with
+ *  its counter set to zero (<em>red state</em>); <tt>fd[0]</tt>, the start of operations semaphore, is left unused.
+ *  The descriptors are not closed on <tt>exec</tt>, so they are inherited by the processes generated afterwards.
+ *
+ *  \param fd array of <tt>snum</tt> + 1 locations where the descriptors are stored
+ *  \param snum number of semaphores in the set (>= 1)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semEventCreate (int fd[], unsigned int snum)
+{
+  unsigned int s;
+  int err;
+
+  fd[0] = -1;
+  for (s = 1; s <= snum; s++)
+    if ((fd[s] = eventfd (0, EFD_SEMAPHORE | EFD_NONBLOCK)) == -1)
+       { err = errno;
+         semEventClose (fd, s - 1);
+         errno = err;
+         return -1;
+       }
+  return 0;
+}
+
+/**
+ *  \brief Closing of a set of event file descriptors.
+ *
+ *  \param fd array of descriptors, as created by <tt>semEventCreate</tt>
+ *  \param snum number of semaphores in the set
+ */
+
+void semEventClose (int fd[], unsigned int snum)
+{
+  unsigned int s;
+
+  for (s = 1; s <= snum; s++)
+    if (fd[s] != -1)
+       { close (fd[s]);
+         fd[s] = -1;
+       }
+}
+
+/**
+ *  \brief Switching the <em>down</em> and <em>up</em> operations to event file descriptors.
+ *
+ *  From now on, every <em>down</em> and <em>up</em> carried out by the calling process on semaphore <tt>s</tt> of the
+ *  set operates on descriptor <tt>fd[s]</tt> instead. The start of operations is still signalled on the semaphore
+ *  set. The array may live in a shared memory region, since the descriptors are inherited with the same numbers.
+ *
+ *  \param fd array of descriptors, as created by <tt>semEventCreate</tt> (\c NULL switches back to the semaphore
+ *     set)
+ */
+
+void semUseEvents (const int fd[])
+{
+  evFd = fd;
+}
@@ -7,9 +7,25 @@
  *     \li creation of a set of semaphores
  *     \li connection to a previously created set of semaphores
  *     \li destruction of a previously created set of semaphores
+ *     \li lookup of a previously created set of semaphores
  *     \li signalling start of operations
  *     \li <em>down</em> of a semaphore within the set
- *     \li <em>up</em> of a semaphore within the set.
+ *     \li <em>down</em> of a semaphore within the set with a timeout
+ *     \li <em>up</em> of a semaphore within the set
+ *     \li <em>down</em> of a semaphore within the set several times at once
+ *     \li <em>up</em> of several semaphores within the set at once
+ *     \li <em>up</em> of a semaphore within the set several times at once
+ *     \li identification of the last process that operated on a semaphore within the set
+ *     \li value of a semaphore within the set
+ *     \li number of processes waiting on a semaphore within the set
+ *     \li counting of the <em>down</em> and <em>up</em> operations
+ *     \li creation of a set of event file descriptors
+ *     \li closing of a set of event file descriptors
+ *     \li switching the <em>down</em> and <em>up</em> operations to event file descriptors.
+ *
+ *  With the event file descriptors backend, each semaphore within the set but the start of operations one is mapped
+ *  onto an <tt>eventfd</tt> in semaphore mode: an <em>up</em> adds to its counter and a <em>down</em> waits with
+ *  <tt>poll</tt> until one unit can be read. The descriptors are inherited across <tt>fork</tt> and <tt>exec</tt>.
  *
  *  \author António Rui Borges - October 1995
  */
@@ -58,6 +74,20 @@ extern int semConnect (int key);
 
 extern int semDestroy (int semgid);
 
+/**
+ *  \brief Lookup of a previously created set of semaphores.
+ *
+ *  Unlike <tt>semConnect</tt>, it does not wait for the start of operations.
+ *  The function fails if there is no semaphore set with a creation key equal to <tt>key</tt>.
+ *
+ *  \param key creation key
+ *
+ *  \return set identifier, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int semLookup (int key);
+
 /**
  *  \brief Signalling start of operations upon initialization of shared data structures.
  *
@@ -85,6 +115,22 @@ extern int semSignal (int semgid);
 
 extern int semDown (int semgid, unsigned int sindex);
 
+/**
+ *  \brief <em>Down</em> of a semaphore within the set with a timeout.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or if the semaphore
+ *  can not be decremented within <tt>timeout</tt> seconds (<tt>errno</tt> is then set to <tt>EAGAIN</tt>).
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param timeout max waiting time (s)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int semDownTimed (int semgid, unsigned int sindex, double timeout);
+
 /**
  *  \brief <em>Up</em> of a semaphore within the set.
  *
@@ -99,4 +145,155 @@ extern int semDown (int semgid, unsigned int sindex);
 
 extern int semUp (int semgid, unsigned int sindex);
 
+/**
+ *  \brief <em>Down</em> of a semaphore within the set several times at once.
+ *
+ *  The process blocks until the semaphore value is at least <tt>n</tt> and then decrements it by <tt>n</tt> (with
+ *  the event file descriptors backend, the units are taken one at a time, so the semaphore must have a single
+ *  waiter).
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param n number of <em>down</em>s
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int semDownMany (int semgid, unsigned int sindex, unsigned int n);
+
+/**
+ *  \brief <em>Up</em> of several semaphores within the set at once.
+ *
+ *  All the semaphores are incremented in a single atomic operation (one after the other with the event file
+ *  descriptors backend).
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or if <tt>n</tt>
+ *  exceeds the maximum number of operations per call.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphores location in the set (1 .. snum)
+ *  \param n number of semaphores
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int semUpEach (int semgid, unsigned int sindex[], unsigned int n);
+
+/**
+ *  \brief <em>Up</em> of a semaphore within the set several times at once.
+ *
+ *  The semaphore value is incremented by <tt>n</tt>.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param n number of <em>up</em>s
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int semUpMany (int semgid, unsigned int sindex, unsigned int n);
+
+/**
+ *  \brief Identification of the last process that operated on a semaphore within the set.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or if
+ *  <tt>sindex</tt> is out of range.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (0 .. snum)
+ *
+ *  \return process identifier (\c 0 if no operation took place), upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int semLastPid (int semgid, unsigned int sindex);
+
+/**
+ *  \brief Value of a semaphore within the set.
+ *
+ *  With the event file descriptors backend, the counter of the descriptor is read from <tt>/proc</tt>.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or if
+ *  <tt>sindex</tt> is out of range.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (0 .. snum)
+ *
+ *  \return semaphore value, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int semGetVal (int semgid, unsigned int sindex);
+
+/**
+ *  \brief Number of processes waiting on a semaphore within the set.
+ *
+ *  Only processes waiting for the value to increase (blocked <em>down</em> operations) are counted.
+ *  The waiters of an event file descriptor can not be counted, so the function fails with <tt>ENOTSUP</tt> when that
+ *  backend is in use.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or if
+ *  <tt>sindex</tt> is out of range.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (0 .. snum)
+ *
+ *  \return number of waiting processes, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int semGetNcnt (int semgid, unsigned int sindex);
+
+/**
+ *  \brief Counting of the <em>down</em> and <em>up</em> operations.
+ *
+ *  From now on, every <em>down</em> and <em>up</em> carried out by the calling process increments
+ *  <tt>*counter</tt> atomically (an operation on several semaphores at once counts as one). The counter may live in
+ *  a shared memory region, so it is shared by several processes.
+ *
+ *  \param counter pointer to the counter (\c NULL stops counting)
+ */
+
+extern void semCount (unsigned long *counter);
+
+/**
+ *  \brief Creation of a set of event file descriptors.
+ *
+ *  One descriptor is created in semaphore mode for each semaphore within a set of <tt>snum</tt> semaphores, with
+ *  its counter set to zero (<em>red state</em>); <tt>fd[0]</tt>, the start of operations semaphore, is left unused.
+ *  The descriptors are not closed on <tt>exec</tt>, so they are inherited by the processes generated afterwards.
+ *
+ *  \param fd array of <tt>snum</tt> + 1 locations where the descriptors are stored
+ *  \param snum number of semaphores in the set (>= 1)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int semEventCreate (int fd[], unsigned int snum);
+
+/**
+ *  \brief Closing of a set of event file descriptors.
+ *
+ *  \param fd array of descriptors, as created by <tt>semEventCreate</tt>
+ *  \param snum number of semaphores in the set
+ */
+
+extern void semEventClose (int fd[], unsigned int snum);
+
+/**
+ *  \brief Switching the <em>down</em> and <em>up</em> operations to event file descriptors.
+ *
+ *  From now on, every <em>down</em> and <em>up</em> carried out by the calling process on semaphore <tt>s</tt> of the
+ *  set operates on descriptor <tt>fd[s]</tt> instead. The start of operations is still signalled on the semaphore
+ *  set. The array may live in a shared memory region, since the descriptors are inherited with the same numbers.
+ *
+ *  \param fd array of descriptors, as created by <tt>semEventCreate</tt> (\c NULL switches back to the semaphore
+ *     set)
+ */
+
+extern void semUseEvents (const int fd[]);
+
 #endif /* SEMAPHORE_H_ */
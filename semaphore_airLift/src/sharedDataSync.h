@@ -17,8 +17,24 @@
 #ifndef SHAREDDATASYNC_H_
 #define SHAREDDATASYNC_H_
 
+#include <time.h>
+
 #include "probConst.h"
 #include "probDataStruct.h"
+#include "histogram.h"
+#include "boardingQueue.h"
+#include "mpscRing.h"
+#include "mailbox.h"
+#include "critRegion.h"
+
+/** \brief number of semaphores in the set */
+#define SEM_NU                    (9 + 3 * (MAXPL - 1) + (MAXDEST - 1))
+/** \brief number of semaphores in the set (reduced-handshake protocol, one more per passenger) */
+#define SEM_NU_FAST               (SEM_NU + N)
+
+#if SEM_NU_FAST >= 32000
+#error "too many passengers for a semaphore set (SEMMSL)"
+#endif
 
 /**
  *  \brief Definition of <em>shared information</em> data type.
@@ -27,29 +43,92 @@ typedef struct
         { /** \brief full state of the problem */
           FULL_STAT fSt;
 
+          /** \brief start of operations (<tt>CLOCK_MONOTONIC</tt>) */
+          struct timespec start;
+          /** \brief arrival time of each passenger at the airport (us after start of operations) */
+          unsigned long arrival[N];
+          /** \brief time each passenger joined the queue (us after start of operations) */
+          unsigned long queued[N];
+          /** \brief waiting time of the passengers, from joining the queue to the departure of their flight */
+          HISTOGRAM wait;
+          /** \brief party of each passenger, identified by the id of its first member (the passenger itself if it
+                     travels alone) */
+          unsigned int group[N];
+          /** \brief number of members of each party, indexed by party id */
+          unsigned int groupSize[N];
+          /** \brief number of members of each party already at the airport, indexed by party id */
+          unsigned int gathered[N];
+          /** \brief destination of each passenger, set at launch (the same for every member of a party) */
+          unsigned int destination[N];
+          /** \brief priority class of each passenger, set at launch (the same for every member of a party) */
+          unsigned int priority[N];
+          /** \brief ids of the passengers in queue for each destination, in order of arrival within each priority class
+                     (reduced-handshake protocol) */
+          BOARDING_QUEUE queue[MAXDEST];
+          /* the members of a party are queued together, by the last one to reach the airport */
+          /** \brief ids of the passengers in queue, in order of arrival (lock-free queue) */
+          MPSC_RING ring;
+          /** \brief queue waiting time of the passengers of each priority class, from joining the queue to the
+                     passport check */
+          HISTOGRAM queueWait[NCLASS];
+          /** \brief number of down and up operations carried out by the intervening entities */
+          unsigned long semOps;
+          /** \brief event file descriptor standing for each semaphore, inherited from the launcher (eventfd backend) */
+          int eventFd[SEM_NU_FAST + 1];
+          /** \brief boarding of the present flight is open (several hostesses) */
+          bool boarding;
+          /** \brief spare units of passengersInQueue used to wake up the hostesses still waiting for a passenger when
+                     boarding closes (several hostesses) */
+          unsigned int spare;
+          /** \brief ids of the passengers already pre-checked while the plane is away (pipelined boarding) */
+          unsigned int preChecked[MAXFC];
+          /** \brief number of pre-checked passengers waiting for the next flight */
+          unsigned int nPreChecked;
+          /** \brief hostess is waiting for the next flight on passengersInQueue, so the pilot rings it with a spare
+                     unit instead of signaling readyForBoarding (pipelined boarding) */
+          bool doorbell;
+          /** \brief plane boarded by each passenger */
+          unsigned int seat[N];
+          /** \brief ids of the passengers on board of each plane, in order of boarding */
+          unsigned int onBoard[MAXPL][MAXFC];
+          /** \brief mailbox of the hostess, written by the pilot at the gate */
+          MAILBOX hostessBox;
+          /** \brief mailbox of each pilot, written by the hostess and then by the last passenger to leave the plane */
+          MAILBOX pilotBox[MAXPL];
+          /** \brief mailbox of each passenger, written by the hostess and then by the pilot of its flight */
+          MAILBOX passengerBox[N];
+          /** \brief number of messages sent by the intervening entities */
+          unsigned long msgOps;
+          /** \brief time waited for and held in the critical regions, per call site */
+          CR_PROFILE crProf;
+
           /* semaphores ids */
           /** \brief identification of critical region protection semaphore – val = 1 */
           unsigned int mutex;
-          /** \brief identification of semaphore used by hostess to wait for passengers - val = 0 */
-          unsigned int passengersInQueue;
+          /** \brief identification of semaphores used by hostess to wait for passengers, one per destination - val = 0 */
+          unsigned int passengersInQueue[MAXDEST];
           /** \brief identification of semaphore used by passengers to wait for hostess – val = 0 */
           unsigned int passengersWaitInQueue;
-          /** \brief identification of semaphore used by passengers to wait for flight to end – val = 0 */
-          unsigned int passengersWaitInFlight;
+          /** \brief identification of semaphores used by passengers to wait for flight to end, one per plane – val = 0 */
+          unsigned int passengersWaitInFlight[MAXPL];
           /** \brief identification of semaphore used by hostess to wait for starting boarding – val = 0  */
           unsigned int readyForBoarding;
-          /** \brief identification of semaphore used by pilot to wait for boarding to complete - val = 0 */
-          unsigned int readyToFlight;
+          /** \brief identification of semaphores used by pilot to wait for boarding to complete, one per plane - val = 0 */
+          unsigned int readyToFlight[MAXPL];
           /** \brief identification of semaphore used by hostess to wait for passenger identification - val = 0 */
           unsigned int idShown;
-          /** \brief identification of semaphore used by pilot to wait for last passenger to leave plane - val = 0 */
-          unsigned int planeEmpty;
+          /** \brief identification of semaphores used by pilot to wait for last passenger to leave plane, one per plane -
+                     val = 0 */
+          unsigned int planeEmpty[MAXPL];
+          /** \brief identification of semaphore used by pilots to take turns at the boarding gate (several planes) -
+                     val = 1 */
+          unsigned int gate;
+          /** \brief identification of the first of the semaphores used by each passenger to wait for the passport
+                     check to complete (reduced-handshake protocol) - val = 0 */
+          unsigned int checkDone;
 
         } SHARED_DATA;
 
-/** \brief number of semaphores in the set */
-#define SEM_NU                    (8)
-
 #define MUTEX                      1
 #define PASSENGERSINQUEUE          2
 #define PASSENGERSWAITINQUEUE      3
@@ -58,5 +137,32 @@ typedef struct
 #define READYTOFLIGHT              6
 #define IDSHOWN                    7
 #define PLANEEMPTY                 8
+#define GATE                       9
+/** \brief first of the semaphores of planes other than the first one (passengersWaitInFlight, readyToFlight and
+           planeEmpty of each plane in turn) */
+#define PLANESEMS                 10
+/** \brief first of the passengersInQueue semaphores of destinations other than the first one */
+#define DESTSEMS                  (PLANESEMS + 3 * (MAXPL - 1))
+#define CHECKDONE                 (SEM_NU + 1)
+
+/* Layout checks: every passenger, flight and seat indexes its own entry, and the semaphore locations fill the set */
+
+/** \brief number of entries of an array member of a structure type */
+#define ENTRIES(type, member)     (sizeof(((type *)0)->member) / sizeof(((type *)0)->member[0]))
+
+_Static_assert(ENTRIES(STAT, passengerStat) == N, "one state per passenger");
+_Static_assert((ENTRIES(SHARED_DATA, arrival) == N) && (ENTRIES(SHARED_DATA, queued) == N) &&
+               (ENTRIES(SHARED_DATA, group) == N) && (ENTRIES(SHARED_DATA, groupSize) == N) &&
+               (ENTRIES(SHARED_DATA, gathered) == N) && (ENTRIES(SHARED_DATA, destination) == N) &&
+               (ENTRIES(SHARED_DATA, priority) == N) && (ENTRIES(SHARED_DATA, seat) == N) &&
+               (ENTRIES(SHARED_DATA, passengerBox) == N), "one entry per passenger");
+_Static_assert((ENTRIES(FULL_STAT, nPassengersInFlight) == MAXNF) && (ENTRIES(FULL_STAT, flightPlane) == MAXNF) &&
+               (ENTRIES(FULL_STAT, flightDest) == MAXNF) && (MAXNF >= N),
+               "one entry per flight, a run flying at least one passenger per flight");
+_Static_assert((ENTRIES(SHARED_DATA, preChecked) == MAXFC) && (ENTRIES(SHARED_DATA, onBoard[0]) == MAXFC) &&
+               (ENTRIES(SHARED_DATA, onBoard) == MAXPL), "one entry per seat of each plane");
+_Static_assert(DESTSEMS + MAXDEST - 2 == SEM_NU, "the last destination semaphore ends the set");
+_Static_assert((CHECKDONE + N - 1 == SEM_NU_FAST) && (ENTRIES(SHARED_DATA, eventFd) == SEM_NU_FAST + 1),
+               "one checkDone semaphore per passenger ends the set of the reduced-handshake protocol");
 
 #endif /* SHAREDDATASYNC_H_ */
@@ -8,7 +8,8 @@
  *      \li connection to a previously created block
  *      \li destruction of a previously created block
  *      \li mapping of the block previously created on the process address space
- *      \li unmapping of the block off the process address space.
+ *      \li unmapping of the block off the process address space
+ *      \li identification of the process that created the block.
  *
  *  \author António Rui Borges - October 1995
  */
@@ -109,3 +110,23 @@ int shmemDettach (void *attAdd)
 {
   return shmdt (attAdd);
 }
+
+/**
+ *  \brief Identification of the process that created the block.
+ *
+ *  The function fails if there is no block with an identifier equal to <tt>shmid</tt>.
+ *
+ *  \param shmid block identifier
+ *
+ *  \return process identifier of the creator, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int shmemCreatorPid (int shmid)
+{
+  struct shmid_ds ds;                                                                           /* block status */
+
+  if (shmctl (shmid, IPC_STAT, &ds) == -1)
+     return -1;
+     else return (int) ds.shm_cpid;
+}